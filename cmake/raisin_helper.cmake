@@ -197,6 +197,175 @@ macro(raisin_windows_only)
     endif()
 endmacro()
 
+#=============================================================================
+# FUNCTION: raisin_precompile_serialization_base
+#
+# Description:
+#   Precompiles raisin_serialization_base.hpp for a target. Every generated
+#   message header includes it, so parsing it once per target instead of once
+#   per translation unit saves most of the cost of including messages.
+#   Ignored on CMake older than 3.16.
+#
+# Arguments:
+#   TARGET_NAME - The target whose sources include generated messages.
+#
+#=============================================================================
+function(raisin_precompile_serialization_base TARGET_NAME)
+    if(CMAKE_VERSION VERSION_LESS 3.16)
+        return()
+    endif()
+    target_precompile_headers(${TARGET_NAME} PRIVATE "${RAISIN_MASTER_INCLUDE}/raisin_serialization_base.hpp")
+endfunction()
+
+#=============================================================================
+# FUNCTION: raisin_unity_build
+#
+# Description:
+#   Compiles the sources of a target in batches of one translation unit each,
+#   so headers shared by the sources (Eigen, raisim, generated messages) are
+#   parsed once per batch. Sources with file-local names that collide, or
+#   that must not be merged, can be listed in EXCLUDE. `raisin build --unity`
+#   turns this on for every target instead. Ignored on CMake older than 3.16.
+#
+# Arguments:
+#   TARGET_NAME - The target to build in batches.
+#   BATCH_SIZE  - (Optional) Sources per batch, 8 by default. 0 is one batch.
+#   EXCLUDE     - (Optional) Sources that are compiled on their own.
+#
+#=============================================================================
+function(raisin_unity_build TARGET_NAME)
+    if(CMAKE_VERSION VERSION_LESS 3.16)
+        return()
+    endif()
+    cmake_parse_arguments(ARG "" "BATCH_SIZE" "EXCLUDE" ${ARGN})
+    if(NOT DEFINED ARG_BATCH_SIZE)
+        set(ARG_BATCH_SIZE 8)
+    endif()
+
+    set_target_properties(${TARGET_NAME} PROPERTIES
+            UNITY_BUILD ON
+            UNITY_BUILD_BATCH_SIZE ${ARG_BATCH_SIZE}
+    )
+    if(ARG_EXCLUDE)
+        # source properties are per directory, so this is called from the directory of the target
+        set_source_files_properties(${ARG_EXCLUDE} PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)
+    endif()
+endfunction()
+
+#=============================================================================
+# FUNCTION: raisin_message_library
+#
+# Description:
+#   Builds the out-of-line message codecs of one project, generated by setup
+#   when 'message_codec_library' is enabled, into a static library. Packages
+#   then only see the declarations and link the library instead of compiling
+#   every codec in every translation unit.
+#
+# Arguments:
+#   LIBRARY_NAME - The target name, <project>_msgs.
+#   SOURCES      - The generated codec sources.
+#   DEPENDS      - (Optional) Message libraries of the nested message types.
+#
+#=============================================================================
+function(raisin_message_library LIBRARY_NAME)
+    cmake_parse_arguments(ARG "" "" "SOURCES;DEPENDS" ${ARGN})
+
+    add_library(${LIBRARY_NAME} STATIC ${ARG_SOURCES})
+    # each source defines the implementation macro of its message before the include guards
+    # of the headers it shares with the other sources, so they must not be merged
+    set_target_properties(${LIBRARY_NAME} PROPERTIES UNITY_BUILD OFF)
+    target_include_directories(${LIBRARY_NAME} PUBLIC
+            $<BUILD_INTERFACE:${RAISIN_MASTER_INCLUDE}>
+            $<INSTALL_INTERFACE:include>
+    )
+    if(ARG_DEPENDS)
+        target_link_libraries(${LIBRARY_NAME} PUBLIC ${ARG_DEPENDS})
+    endif()
+    raisin_precompile_serialization_base(${LIBRARY_NAME})
+
+    install(
+            TARGETS ${LIBRARY_NAME}
+            EXPORT export_raisin_message_libraries
+            ARCHIVE DESTINATION lib
+            INCLUDES DESTINATION include
+    )
+endfunction()
+
+#=============================================================================
+# FUNCTION: raisin_install_message_libraries
+#
+# Description:
+#   Installs the export set of all raisin_message_library targets, so that
+#   installed packages linking them can be found again.
+#
+#=============================================================================
+function(raisin_install_message_libraries)
+    install(
+            EXPORT export_raisin_message_libraries
+            FILE raisin_message_librariesTargets.cmake
+            DESTINATION lib/cmake/raisin_message_libraries
+    )
+endfunction()
+
+#=============================================================================
+# FUNCTION: raisin_serialization_benchmark
+#
+# Description:
+#   Builds raisin_serialization_benchmark, which measures ns/op, GB/s and heap
+#   allocations per op of the generated codecs. Its messages are generated by
+#   setup when 'serialization_benchmark' is enabled. The executable is not
+#   installed; script/continuous_build.py runs it from the release build
+#   directory.
+#
+# Arguments:
+#   SOURCE - The benchmark source, templates/benchmark/serialization_benchmark.cpp.
+#
+#=============================================================================
+function(raisin_serialization_benchmark SOURCE)
+    add_executable(raisin_serialization_benchmark ${SOURCE})
+    target_include_directories(raisin_serialization_benchmark PRIVATE ${RAISIN_MASTER_INCLUDE})
+    raisin_precompile_serialization_base(raisin_serialization_benchmark)
+endfunction()
+
+#=============================================================================
+# FUNCTION: raisin_serialization_tests
+#
+# Description:
+#   Builds one executable per *_test.cpp in DIR and registers it with CTest,
+#   so `ctest` in the build directory checks the generated codecs and the
+#   concurrent structures of the opt-in headers. Their messages are generated
+#   by setup when 'serialization_tests' is enabled. Tests with "eigen" in
+#   their name are skipped when Eigen is not found. enable_testing() must be
+#   called in the top-level directory first; inside a function it has no
+#   effect.
+#
+# Arguments:
+#   DIR - The test directory, templates/tests.
+#
+#=============================================================================
+function(raisin_serialization_tests DIR)
+    find_package(Threads REQUIRED)
+    find_package(Eigen3 QUIET)
+
+    file(GLOB test_sources CONFIGURE_DEPENDS ${DIR}/*_test.cpp)
+    foreach(source ${test_sources})
+        get_filename_component(test_name ${source} NAME_WE)
+        set(target_name raisin_${test_name})
+        if(test_name MATCHES "eigen" AND NOT TARGET Eigen3::Eigen)
+            message(STATUS "Eigen not found, skipping ${target_name}")
+            continue()
+        endif()
+
+        add_executable(${target_name} ${source})
+        target_include_directories(${target_name} PRIVATE ${RAISIN_MASTER_INCLUDE} ${DIR})
+        target_link_libraries(${target_name} PRIVATE Threads::Threads)
+        if(test_name MATCHES "eigen")
+            target_link_libraries(${target_name} PRIVATE Eigen3::Eigen)
+        endif()
+        add_test(NAME ${target_name} COMMAND ${target_name})
+    endforeach()
+endfunction()
+
 #=============================================================================
 # FUNCTION: update_build_dir_in_yaml
 #
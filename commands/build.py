@@ -7,6 +7,7 @@ Builds the project using CMake and Ninja.
 import os
 import sys
 import platform
+import shutil
 import subprocess
 import click
 from pathlib import Path
@@ -16,13 +17,99 @@ from commands import globals as g
 from commands.utils import delete_directory
 
 
-def build_command(build_types, to_install=False):
+def _cmake_cache_value(build_dir, key):
+    """
+    Value of a variable in the CMakeCache.txt of build_dir, or None if it is not set.
+    """
+    cache_path = Path(build_dir) / "CMakeCache.txt"
+    if not cache_path.is_file():
+        return None
+    with open(cache_path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            name, _, value = line.partition("=")
+            if name.split(":")[0] == key:
+                return value.strip()
+    return None
+
+
+def _cache_value_matches(cached, expected):
+    """
+    True if a CMakeCache.txt value equals the value passed on the command line, comparing booleans
+    and paths the way CMake treats them.
+    """
+    if cached is None:
+        return False
+    truthy = ["ON", "TRUE", "YES", "Y", "1"]
+    falsy = ["OFF", "FALSE", "NO", "N", "0", ""]
+    if expected.upper() in truthy + falsy:
+        return (cached.upper() in truthy) == (expected.upper() in truthy)
+    if cached == expected:
+        return True
+    if os.path.isabs(expected):
+        return os.path.normcase(os.path.normpath(cached)) == os.path.normcase(os.path.normpath(expected))
+    return False
+
+
+def _needs_configure(build_dir, generator_file, cmake_command, env=None):
+    """
+    A build directory is configured once. Afterwards the build tool reruns CMake by itself when
+    CMakeLists.txt or another CMake input changes, so it only has to be configured again when the
+    generator, a -D cache entry of cmake_command or the compiler selected by CXX/CC differs from
+    what CMakeCache.txt holds.
+    """
+    if not (Path(build_dir) / generator_file).is_file():
+        return True
+    expected = {}
+    for index, arg in enumerate(cmake_command):
+        if arg.startswith("-D"):
+            name, _, value = arg[2:].partition("=")
+            expected[name.split(":")[0]] = value
+        elif arg == "-G" and index + 1 < len(cmake_command):
+            expected["CMAKE_GENERATOR"] = cmake_command[index + 1]
+    env = os.environ if env is None else env
+    for variable, cache_key in [("CXX", "CMAKE_CXX_COMPILER"), ("CC", "CMAKE_C_COMPILER")]:
+        compiler = shutil.which(env[variable]) if env.get(variable) else None
+        if compiler:
+            expected.setdefault(cache_key, os.path.realpath(compiler))
+    for name, value in expected.items():
+        cached = _cmake_cache_value(build_dir, name)
+        if name in ["CMAKE_CXX_COMPILER", "CMAKE_C_COMPILER"] and cached:
+            cached = os.path.realpath(cached)
+        if not _cache_value_matches(cached, value):
+            print(f"🔧 {name} changed to '{value}', configuring again.")
+            return True
+    return False
+
+
+def _run_cmake_configure(cmake_command, env=None):
+    try:
+        subprocess.run(cmake_command, check=True, text=True, env=env)
+    except subprocess.CalledProcessError as e:
+        # If the command fails, print its output to help with debugging
+        print("--- CMake Command Failed ---", file=sys.stderr)
+        print(f"Return Code: {e.returncode}", file=sys.stderr)
+        print("\n--- STDOUT ---", file=sys.stderr)
+        print(e.stdout, file=sys.stderr)
+        print("\n--- STDERR ---", file=sys.stderr)
+        print(e.stderr, file=sys.stderr)
+        print("--------------------------", file=sys.stderr)
+        sys.exit(1)
+
+
+def build_command(build_types, to_install=False, clean=False, jobs=None, unity=False):
     """
     Build the project with CMake and Ninja.
 
+    The cmake-build-<type> directories are reused, so only what changed since the last build is
+    recompiled. On Linux the requested build types are compiled concurrently. The jobs are split
+    statically: each of N build types runs ninja with jobs // N, even after the others finished.
+
     Args:
         build_types (list): List of build types ('debug', 'release')
         to_install (bool): Whether to run install target after build
+        clean (bool): Delete the build directories first and build from scratch
+        jobs (int): Parallel compile jobs, split evenly between the build types, half the cores by default
+        unity (bool): Compile every target as a unity build (CMAKE_UNITY_BUILD)
     """
     script_directory = g.script_directory
     developer_env = g.developer_env
@@ -32,88 +119,98 @@ def build_command(build_types, to_install=False):
     if not build_types or (not "debug" in build_types and not "release" in build_types):
         build_types = ["debug"]
 
-    for build_type in build_types:
-        if build_type not in ["release", "debug"]:
-            continue
-
-        # Setup build directory
-        build_type = build_type.lower()
-        build_dir = Path(script_directory) / f"cmake-build-{build_type}"
-        build_type_capitalized = build_type.capitalize()
-        delete_directory(build_dir)
-        build_dir.mkdir(parents=True, exist_ok=True)
-        print(f"building in {build_dir}, build type is {build_type_capitalized}")
-
-        if platform.system().lower() == "linux":
-            try:
-                # CMake configuration
-                cmake_command = [
-                    "cmake",
-                    "-S",
-                    script_directory,
-                    "-G",
-                    "Ninja",
-                    "-B",
-                    str(build_dir),
-                    f"-DCMAKE_BUILD_TYPE={build_type_capitalized}",
-                ]
-                subprocess.run(cmake_command, check=True, text=True)
-            except subprocess.CalledProcessError as e:
-                # If the command fails, print its output to help with debugging
-                print("--- CMake Command Failed ---", file=sys.stderr)
-                print(f"Return Code: {e.returncode}", file=sys.stderr)
-                print("\n--- STDOUT ---", file=sys.stderr)
-                print(e.stdout, file=sys.stderr)
-                print("\n--- STDERR ---", file=sys.stderr)
-                print(e.stderr, file=sys.stderr)
-                print("--------------------------", file=sys.stderr)
-                sys.exit(1)
-
-            print("✅ CMake configuration successful.")
-            print("🛠️  Building with Ninja...")
-            core_count = int(os.cpu_count() / 2) or 4
-            print(f"🔩 Using {core_count} cores for the build.")
+    build_types = [
+        build_type.lower() for build_type in dict.fromkeys(build_types) if build_type in ["release", "debug"]
+    ]
+    unity_flag = f"-DCMAKE_UNITY_BUILD={'ON' if unity else 'OFF'}"
 
-            # Build with Ninja
-            if to_install:
-                build_command = ["ninja", "install", f"-j{core_count}"]
+    if platform.system().lower() == "linux":
+        build_dirs = {}
+        for build_type in build_types:
+            # Setup build directory
+            build_dir = Path(script_directory) / f"cmake-build-{build_type}"
+            build_type_capitalized = build_type.capitalize()
+            if clean:
+                delete_directory(build_dir)
+            build_dir.mkdir(parents=True, exist_ok=True)
+            build_dirs[build_type] = build_dir
+            print(f"building in {build_dir}, build type is {build_type_capitalized}")
+
+            # CMake configuration
+            cmake_command = [
+                "cmake",
+                "-S",
+                script_directory,
+                "-G",
+                "Ninja",
+                "-B",
+                str(build_dir),
+                f"-DCMAKE_BUILD_TYPE={build_type_capitalized}",
+                unity_flag,
+            ]
+            if _needs_configure(build_dir, "build.ninja", cmake_command):
+                _run_cmake_configure(cmake_command)
+                print("✅ CMake configuration successful.")
             else:
-                build_command = ["ninja", f"-j{core_count}"]
-            subprocess.run(build_command, cwd=build_dir, check=True, text=True)
-
-        else:  # Windows
-            try:
-                # CMake configuration
-                cmake_command = [
-                    "cmake",
-                    "--preset",
-                    f"windows-{build_type.lower()}",
-                    "-S",
-                    script_directory,
-                    "-B",
-                    str(build_dir),
-                    f"-DCMAKE_TOOLCHAIN_FILE={script_directory}/vcpkg/scripts/buildsystems/vcpkg.cmake",
-                    "-DRAISIN_RELEASE_BUILD=ON",
-                ]
-                subprocess.run(cmake_command, check=True, text=True, env=developer_env)
-
-            except subprocess.CalledProcessError as e:
-                # If the command fails, print its output to help with debugging
-                print("--- CMake Command Failed ---", file=sys.stderr)
-                print(f"Return Code: {e.returncode}", file=sys.stderr)
-                print("\n--- STDOUT ---", file=sys.stderr)
-                print(e.stdout, file=sys.stderr)
-                print("\n--- STDERR ---", file=sys.stderr)
-                print(e.stderr, file=sys.stderr)
-                print("--------------------------", file=sys.stderr)
-                sys.exit(1)
-
-            print("✅ CMake configuration successful.")
+                print("✅ Reusing the CMake configuration, ninja reconfigures if CMakeLists.txt changed.")
+
+        print("🛠️  Building with Ninja...")
+        core_count = jobs or int(os.cpu_count() / 2) or 4
+        jobs_per_build = max(1, core_count // len(build_dirs))
+        print(f"🔩 Using {core_count} cores for the build, a fixed {jobs_per_build} for each build type.")
+
+        # Build all types at once. the status prefix tells their output apart
+        processes = {}
+        for build_type, build_dir in build_dirs.items():
+            env = dict(os.environ, NINJA_STATUS=f"[{build_type} %f/%t] ")
+            processes[build_type] = subprocess.Popen(
+                ["ninja", f"-j{jobs_per_build}"], cwd=build_dir, text=True, env=env
+            )
+        failed = [build_type for build_type, process in processes.items() if process.wait() != 0]
+        if failed:
+            print(f"❌ Build failed for: {', '.join(failed)}", file=sys.stderr)
+            sys.exit(1)
+
+        # Install one after the other, since all build types install into the same prefix
+        if to_install:
+            for build_dir in build_dirs.values():
+                subprocess.run(
+                    ["ninja", "install", f"-j{core_count}"], cwd=build_dir, check=True, text=True
+                )
+
+    else:  # Windows
+        for build_type in build_types:
+            # Setup build directory
+            build_dir = Path(script_directory) / f"cmake-build-{build_type}"
+            build_type_capitalized = build_type.capitalize()
+            if clean:
+                delete_directory(build_dir)
+            build_dir.mkdir(parents=True, exist_ok=True)
+            print(f"building in {build_dir}, build type is {build_type_capitalized}")
+
+            # CMake configuration
+            cmake_command = [
+                "cmake",
+                "--preset",
+                f"windows-{build_type.lower()}",
+                "-S",
+                script_directory,
+                "-B",
+                str(build_dir),
+                f"-DCMAKE_TOOLCHAIN_FILE={script_directory}/vcpkg/scripts/buildsystems/vcpkg.cmake",
+                "-DRAISIN_RELEASE_BUILD=ON",
+                unity_flag,
+            ]
+            if _needs_configure(build_dir, "CMakeCache.txt", cmake_command, env=developer_env):
+                _run_cmake_configure(cmake_command, env=developer_env)
+                print("✅ CMake configuration successful.")
+
             print("🛠️  Building with Ninja...")
 
             # Build with CMake
+            parallel_args = ["--parallel", str(jobs)] if jobs else ["--parallel"]
             subprocess.run(
-                ["cmake", "--build", str(build_dir), "--parallel"],
+                ["cmake", "--build", str(build_dir)] + parallel_args,
                 check=True,
                 text=True,
                 env=developer_env,
@@ -151,8 +248,25 @@ def build_command(build_types, to_install=False):
     is_flag=True,
     help="Install artifacts to install/ directory after building",
 )
+@click.option(
+    "--clean",
+    is_flag=True,
+    help="Delete the build and generated directories first and build from scratch",
+)
+@click.option(
+    "--jobs",
+    "-j",
+    type=int,
+    default=None,
+    help="Parallel compile jobs, split evenly between the build types (default: half the cores)",
+)
+@click.option(
+    "--unity",
+    is_flag=True,
+    help="Compile every target as a unity build",
+)
 @click.argument("targets", nargs=-1)
-def build_cli_command(build_types, install, targets):
+def build_cli_command(build_types, install, clean, jobs, unity, targets):
     """
     Compile the project using CMake and Ninja.
 
@@ -162,9 +276,12 @@ def build_cli_command(build_types, install, targets):
         raisin build --type debug --install          # Build debug and install
         raisin build -t release -t debug -i          # Build both types and install
         raisin build -t release raisin_network       # Build specific target
+        raisin build -t release --clean              # Rebuild from scratch
+        raisin build -t release -t debug -j 16       # Both types concurrently, 8 jobs each
 
     \b
-    Note: This command first runs setup, then compiles.
+    Note: This command first runs setup, then compiles. Build directories are
+    reused, so only what changed since the last build is recompiled.
     """
     # Import here to avoid circular dependency
     from commands.setup import setup, process_build_targets
@@ -179,6 +296,9 @@ def build_cli_command(build_types, install, targets):
     else:
         click.echo(f"🛠️  building the following targets: {g.build_pattern}")
 
+    if clean:
+        delete_directory(Path(g.script_directory) / "generated")
+
     setup()
 
     # Then build
@@ -189,4 +309,4 @@ def build_cli_command(build_types, install, targets):
         click.echo("   Example: raisin build --type release")
         sys.exit(1)
 
-    build_command(build_types, to_install=install)
+    build_command(build_types, to_install=install, clean=clean, jobs=jobs, unity=unity)
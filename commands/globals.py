@@ -8,6 +8,28 @@ and shared across all command modules.
 # Build pattern filters
 build_pattern = []
 
+# (package, message) pairs whose serialized size is a compile-time constant
+fixed_size_messages = set()
+
+# (package, message) -> [(data_type, data_name, annotations)] of every .msg file, used for type hashes
+message_fields = dict()
+
+# compile message codecs into per-project <project>_msgs libraries instead of inlining them in every includer
+message_codec_library = False
+
+# project -> generated codec sources, and project -> projects whose messages it nests. filled in codec library mode
+message_library_sources = dict()
+message_library_dependencies = dict()
+
+# build raisin_serialization_benchmark and generate the messages it uses
+serialization_benchmark = False
+
+# build the tests of templates/tests, registered with ctest, and generate the messages they use
+serialization_tests = False
+
+# files written by this setup through write_if_changed, so stale ones of a previous setup can be removed
+generated_files = set()
+
 # System information (initialized in main)
 os_type = ""
 architecture = ""
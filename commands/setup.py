@@ -21,7 +21,14 @@ from typing import List, Tuple, Dict, Any, Set, Optional
 # Import globals, constants, and utilities
 from commands import globals as g
 from commands.constants import Colors, TYPE_MAPPING, STRING_TYPES
-from commands.utils import load_configuration, delete_directory
+from commands.utils import (
+    load_configuration,
+    delete_directory,
+    write_if_changed,
+    copy_if_changed,
+    copy_tree_if_changed,
+    remove_stale_generated_files,
+)
 
 
 # ============================================================================
@@ -100,6 +107,15 @@ def process_build_targets(targets):
         g.build_pattern = found_patterns
 
 
+def is_installed_interface(interface_file):
+    """
+    False for the interface packages under templates/ (the messages of the tests and the benchmark).
+    They are generated for this workspace only and are kept out of the install tree.
+    """
+    templates_dir = (Path(g.script_directory) / "templates").resolve()
+    return templates_dir not in Path(interface_file).resolve().parents
+
+
 def create_service_file(srv_file, project_directory, install_dir):
     """
     Create a service file based on the template, replacing the appropriate placeholders.
@@ -122,9 +138,10 @@ def create_service_file(srv_file, project_directory, install_dir):
     # Recreate the directory to ensure it's clean
     os.makedirs(include_project_srv_dir, exist_ok=True)
 
-    destination_file = os.path.join(install_dir, "messages", project_name, "srv", "")
-    os.makedirs(destination_file, exist_ok=True)
-    shutil.copy2(srv_file, destination_file)
+    if is_installed_interface(srv_file):
+        destination_file = os.path.join(install_dir, "messages", project_name, "srv", "")
+        os.makedirs(destination_file, exist_ok=True)
+        shutil.copy2(srv_file, destination_file)
 
     # Read the template
     with open(template_path, "r") as template_file:
@@ -186,19 +203,43 @@ def create_service_file(srv_file, project_directory, install_dir):
                 )
 
     # Process the request and response contents
-    request_includes, request_members, request_buffer_members, request_buffer_size = (
-        process_service_content(request_content, project_name)
-    )
+    (
+        request_includes,
+        request_members,
+        request_buffer_members,
+        request_write_members,
+        request_read_members,
+        request_buffer_size,
+    ) = process_service_content(request_content, project_name)
     (
         response_includes,
         response_members,
         response_buffer_members,
+        response_write_members,
+        response_read_members,
         response_buffer_size,
     ) = process_service_content(response_content, project_name)
 
     # Replace placeholders in the template
     class_name = service_name.replace("_", "")
     service_content = template_content.replace("@@SERVICE_NAME@@", class_name)
+
+    request_definition = structural_definition(
+        read_interface_fields(request_content), project_name
+    )
+    response_definition = structural_definition(
+        read_interface_fields(response_content), project_name
+    )
+    service_content = service_content.replace(
+        "@@REQUEST_TYPE_HASH@@", type_hash_literal(request_definition)
+    )
+    service_content = service_content.replace(
+        "@@RESPONSE_TYPE_HASH@@", type_hash_literal(response_definition)
+    )
+    service_content = service_content.replace(
+        "@@TYPE_HASH@@",
+        type_hash_literal(request_definition + "---" + response_definition),
+    )
     service_content = service_content.replace("@@INCLUDE_PATH@@", "\n".join(includes))
     service_content = service_content.replace(
         "@@REQUEST_INCLUDES@@", "\n".join(request_includes)
@@ -214,21 +255,31 @@ def create_service_file(srv_file, project_directory, install_dir):
     response_get_buffer_member_string = ""
     response_equal_buffer_member_string = ""
 
+    request_get_reader_member_string = ""
+    response_get_reader_member_string = ""
+
+    for wm in request_write_members:
+        request_set_buffer_member_string += f"::raisin::setBuffer(buffer, {wm});\n"
+
+    for rm in request_read_members:
+        request_get_buffer_member_string += f"temp = ::raisin::getBuffer(temp, {rm});\n"
+        request_get_reader_member_string += f"::raisin::getBuffer(reader, {rm});\n"
+
     for bm in request_buffer_members:
-        request_set_buffer_member_string += f"::raisin::setBuffer(buffer, {bm});\n"
-        request_get_buffer_member_string += f"temp = ::raisin::getBuffer(temp, {bm});\n"
         request_equal_buffer_member_string += f"&& this->{bm} == other.{bm} \n"
 
-    for bm in response_buffer_members:
-        response_set_buffer_member_string += f"::raisin::setBuffer(buffer, {bm});\n"
+    for wm in response_write_members:
+        response_set_buffer_member_string += f"::raisin::setBuffer(buffer, {wm});\n"
+
+    for rm in response_read_members:
         response_get_buffer_member_string += (
-            f"temp = ::raisin::getBuffer(temp, {bm});\n"
+            f"temp = ::raisin::getBuffer(temp, {rm});\n"
         )
+        response_get_reader_member_string += f"::raisin::getBuffer(reader, {rm});\n"
+
+    for bm in response_buffer_members:
         response_equal_buffer_member_string += f"&& this->{bm} == other.{bm} \n"
 
-    service_content = service_content.replace(
-        "@@REQUEST_SET_BUFFER_MEMBERS@@", request_set_buffer_member_string
-    )
     modified_request_set_buffer_member_string = "\n".join(
         "buffer = " + line for line in request_set_buffer_member_string.splitlines()
     )
@@ -238,6 +289,9 @@ def create_service_file(srv_file, project_directory, install_dir):
     service_content = service_content.replace(
         "@@REQUEST_GET_BUFFER_MEMBERS@@", request_get_buffer_member_string
     )
+    service_content = service_content.replace(
+        "@@REQUEST_GET_READER_MEMBERS@@", request_get_reader_member_string
+    )
     service_content = service_content.replace(
         "@@REQUEST_EQUAL_BUFFER_MEMBERS@@", request_equal_buffer_member_string
     )
@@ -245,9 +299,6 @@ def create_service_file(srv_file, project_directory, install_dir):
         "@@REQUEST_BUFFER_SIZE@@", "\n  ".join(request_buffer_size)
     )
 
-    service_content = service_content.replace(
-        "@@RESPONSE_SET_BUFFER_MEMBERS@@", response_set_buffer_member_string
-    )
     modified_response_set_buffer_member_string = "\n".join(
         "buffer = " + line for line in response_set_buffer_member_string.splitlines()
     )
@@ -257,6 +308,9 @@ def create_service_file(srv_file, project_directory, install_dir):
     service_content = service_content.replace(
         "@@RESPONSE_GET_BUFFER_MEMBERS@@", response_get_buffer_member_string
     )
+    service_content = service_content.replace(
+        "@@RESPONSE_GET_READER_MEMBERS@@", response_get_reader_member_string
+    )
     service_content = service_content.replace(
         "@@RESPONSE_EQUAL_BUFFER_MEMBERS@@", response_equal_buffer_member_string
     )
@@ -287,18 +341,19 @@ def create_service_file(srv_file, project_directory, install_dir):
     snake_str = snake_str.replace("__", "_")
     output_path = os.path.join(include_project_srv_dir, f"{snake_str}.hpp")
 
-    with open(output_path, "w") as output_file:
-        output_file.write(service_content)
+    write_if_changed(output_path, service_content)
 
 
 def process_service_content(content, project_name):
     """
     Process the service content (either request or response part).
-    It returns the includes, members, and buffer_members lists.
+    It returns the includes, members, buffer_members, write_members, read_members and buffer_size lists.
     """
     includes = []
     members = []
     buffer_members = []
+    write_members = []
+    read_members = []
     buffer_size = []
 
     for line in content.splitlines():
@@ -311,6 +366,7 @@ def process_service_content(content, project_name):
         if not line:
             continue
 
+        line, annotations = parse_field_annotations(line)
         parts = line.split()
         parts_in_two = line.split(" ", 1)
 
@@ -346,41 +402,19 @@ def process_service_content(content, project_name):
                 members.append(f"{transformed_type} {data_name};")
 
             buffer_members.append(f"{data_name}")
-
-            if transformed_type.startswith(
-                "std::vector"
-            ) or transformed_type.startswith("std::array"):
-                if base_type in STRING_TYPES:
-                    buffer_size.append(
-                        f"temp += sizeof(uint32_t); \n for (const auto& v : {data_name}) temp += sizeof(uint32_t) + v.size();\n"
-                    )
-                elif base_type in TYPE_MAPPING.values():
-                    buffer_size.append(
-                        f"temp += {data_name}.size() * sizeof({data_name});\n"
-                    )
-                else:
-                    buffer_size.append(
-                        f"for (const auto& v : {data_name}) temp += v.getSize();\n"
-                    )
-            else:
-                if transformed_type in STRING_TYPES:
-                    buffer_size.append(
-                        f"temp += sizeof(uint32_t) + {data_name}.size();\n"
-                    )
-                elif (
-                    transformed_type in TYPE_MAPPING.values()
-                    and transformed_type != "std::string"
-                    and transformed_type != "std::u16string"
-                ):
-                    buffer_size.append(f"temp += sizeof({data_name});\n")
-                else:
-                    buffer_size.append(f"temp += {data_name}.getSize();\n")
+            write_member, read_member, member_size, _ = annotated_member_codec(
+                data_type, data_name, transformed_type, base_type, annotations
+            )
+            add_codec_include(includes, write_member)
+            write_members.append(write_member)
+            read_members.append(read_member)
+            buffer_size.append(member_size)
 
         elif "=" in line:
             parts = line.split(" ", 1)
             members.append(f"static constexpr {TYPE_MAPPING[parts[0]]} {parts[1]};")
 
-    return includes, members, buffer_members, buffer_size
+    return includes, members, buffer_members, write_members, read_members, buffer_size
 
 
 def find_topic_directories(search_directories):
@@ -501,9 +535,7 @@ def find_interface_files(search_directories, interface_types, packages_to_ignore
 
             if (Path(root) / "include").is_dir():
                 if (Path(root) / "msg").is_dir() or (Path(root) / "srv").is_dir():
-                    shutil.copytree(
-                        Path(root) / "include", generated_dest_dir, dirs_exist_ok=True
-                    )
+                    copy_tree_if_changed(Path(root) / "include", generated_dest_dir)
 
             # The name of the directory we are currently in (e.g., 'msg', 'srv')
             current_dir_name = os.path.basename(root)
@@ -724,20 +756,63 @@ def update_cmake_file(project_directories, cmake_dir):
                 subdirectory_lines.append(f"add_subdirectory({project_dir})")
 
     cmake_content = cmake_template_content.replace(
+        "@@MESSAGE_LIBRARIES@@", message_library_lines()
+    )
+    cmake_content = cmake_content.replace(
+        "@@SERIALIZATION_BENCHMARK@@",
+        "raisin_serialization_benchmark(@@SCRIPT_DIR@@/templates/benchmark/serialization_benchmark.cpp)"
+        if g.serialization_benchmark
+        else "",
+    )
+    cmake_content = cmake_content.replace(
+        "@@SERIALIZATION_TESTS@@",
+        "enable_testing()\nraisin_serialization_tests(@@SCRIPT_DIR@@/templates/tests)"
+        if g.serialization_tests
+        else "",
+    )
+    cmake_content = cmake_content.replace(
         "@@SUB_PROJECT@@", "\n".join(subdirectory_lines)
     )
     cmake_content = cmake_content.replace("@@SCRIPT_DIR@@", g.script_directory)
 
     cmake_file_path = os.path.join(g.script_directory, "CMakeLists.txt")
 
-    with open(cmake_file_path, "w") as cmake_file:
-        cmake_file.write(cmake_content)
+    # an unchanged CMakeLists.txt keeps its mtime, so ninja does not rerun the configure step
+    write_if_changed(cmake_file_path, cmake_content)
 
     print(
         f"📂 Generated CMakeLists.txt at {cmake_file_path} with {len(subdirectory_lines)} projects."
     )
 
 
+def message_library_lines():
+    """
+    CMake lines defining a <project>_msgs library per project with generated codec sources.
+    The libraries are linked to every package added after them. Empty unless in codec library mode.
+    """
+    if not g.message_library_sources:
+        return ""
+
+    lines = []
+    library_names = []
+    for project_name, sources in sorted(g.message_library_sources.items()):
+        dependencies = [
+            f"{dep}_msgs"
+            for dep in sorted(g.message_library_dependencies.get(project_name, set()))
+            if dep in g.message_library_sources
+        ]
+        lines.append(f"raisin_message_library({project_name}_msgs")
+        lines.append(f"        SOURCES {' '.join(sorted(sources))}")
+        if dependencies:
+            lines.append(f"        DEPENDS {' '.join(dependencies)}")
+        lines.append(")")
+        library_names.append(f"{project_name}_msgs")
+
+    lines.append("raisin_install_message_libraries()")
+    lines.append(f"link_libraries({' '.join(library_names)})")
+    return "\n".join(lines)
+
+
 def transform_data_type(data_type, project_name):
     """
     Transform the data type based on whether it ends in [] or [N].
@@ -814,6 +889,290 @@ def transform_data_type(data_type, project_name):
         return f"{project_name}::msg::{data_type}", data_type, subproject_path, False
 
 
+def buffer_size_expression(transformed_type, base_type, data_name):
+    """
+    Return the C++ statement that adds the exact serialized size of a member to 'temp'.
+    Must match the wire format of raisin_serialization_base.hpp byte for byte, since
+    the generated setBuffer sizes its output buffer with getSize().
+    """
+    is_vector = transformed_type.startswith("std::vector")
+    is_array = transformed_type.startswith("std::array")
+
+    if is_vector or is_array:
+        prefix = "temp += sizeof(uint32_t);\n  " if is_vector else ""
+        if base_type in STRING_TYPES:
+            return (
+                prefix
+                + f"for (const auto& v : {data_name}) temp += sizeof(uint32_t) + v.size() * sizeof(v[0]);"
+            )
+        elif base_type in TYPE_MAPPING.values():
+            if is_array:
+                return f"temp += sizeof({data_name});"
+            return prefix + f"temp += {data_name}.size() * sizeof(_{data_name}_type::value_type);"
+        else:
+            return prefix + f"for (const auto& v : {data_name}) temp += v.getSize();"
+    elif transformed_type in STRING_TYPES:
+        return f"temp += sizeof(uint32_t) + {data_name}.size() * sizeof({data_name}[0]);"
+    elif transformed_type in TYPE_MAPPING.values():
+        return f"temp += sizeof({data_name});"
+    else:
+        return f"temp += {data_name}.getSize();"
+
+
+FIELD_ANNOTATION_PATTERN = re.compile(r"@([A-Za-z_][A-Za-z0-9_]*)(?:\(([^)]*)\))?")
+
+
+def parse_field_annotations(line):
+    """
+    Strip '@name' and '@name(arg)' annotations from a .msg/.srv field line.
+    Returns the remaining line and a dict mapping each annotation name to its argument ('' if none).
+    """
+    annotations = {
+        match.group(1): (match.group(2) or "").strip()
+        for match in FIELD_ANNOTATION_PATTERN.finditer(line)
+    }
+    return " ".join(FIELD_ANNOTATION_PATTERN.sub("", line).split()), annotations
+
+
+COMPRESSION_CODECS = {"lz4": "kLz4", "zstd": "kZstd"}
+DEFAULT_COMPRESSION_THRESHOLD = 1024
+
+
+def add_codec_include(includes, write_member):
+    """
+    Add the opt-in header that defines the codec of an annotated member, if it needs one.
+    """
+    if write_member.startswith("::raisin::CompressedField"):
+        include = '#include "../../raisin_compression.hpp"'
+        if include not in includes:
+            includes.append(include)
+
+
+def annotated_member_codec(data_type, data_name, transformed_type, base_type, annotations):
+    """
+    Return how a member is serialized:
+    the expression passed to setBuffer/appendSegments, the expression passed to getBuffer,
+    the getSize statement and the type used as ViewTraits key.
+    """
+    default_size = buffer_size_expression(transformed_type, base_type, data_name)
+    if "eigen" in annotations:
+        if transformed_type.startswith("Eigen::Matrix"):
+            if "compress" in annotations or "bitpacked" in annotations:
+                print(
+                    f"{Colors.YELLOW}Warning: @eigen fields are not compressed or bit-packed, ignored on '{data_name}'{Colors.RESET}"
+                )
+            if data_type.endswith("[]"):
+                return (
+                    f"::raisin::EigenVectorRef<const _{data_name}_type>{{{data_name}}}",
+                    f"::raisin::EigenVectorRef<_{data_name}_type>{{{data_name}}}",
+                    f"temp += sizeof(uint32_t);\n  temp += {data_name}.size() * sizeof({base_type});",
+                    f"std::vector<{base_type}>",
+                )
+            size = data_type.rsplit("[", 1)[1].rstrip("]")
+            return (
+                f"::raisin::EigenVectorRef<const _{data_name}_type>{{{data_name}}}",
+                f"::raisin::EigenVectorRef<_{data_name}_type>{{{data_name}}}",
+                f"temp += {size} * sizeof({base_type});",
+                f"std::array<{base_type}, {size}>",
+            )
+        print(
+            f"{Colors.YELLOW}Warning: @eigen is only supported in .msg files, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+    if "soa" in annotations:
+        if transformed_type == f"_{data_name}_columns":
+            return (
+                f"::raisin::StructOfArraysRef<const _{data_name}_type>{{{data_name}}}",
+                f"::raisin::StructOfArraysRef<_{data_name}_type>{{{data_name}}}",
+                default_size,
+                f"::raisin::StructOfArrays<_{data_name}_type>",
+            )
+        print(
+            f"{Colors.YELLOW}Warning: @soa is only supported in .msg files, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+    if "compress" in annotations:
+        codec, _, threshold = annotations["compress"].partition(",")
+        codec, threshold = codec.strip(), threshold.strip() or str(DEFAULT_COMPRESSION_THRESHOLD)
+        element_type = data_type.split("[", 1)[0]
+        if codec not in COMPRESSION_CODECS or not threshold.isdigit():
+            print(
+                f"{Colors.YELLOW}Warning: unknown @compress({annotations['compress']}) on '{data_type} {data_name}', ignored. "
+                f"Use @compress(lz4|zstd[, threshold]){Colors.RESET}"
+            )
+        elif not data_type.endswith("]") or element_type not in TYPE_MAPPING:
+            print(
+                f"{Colors.YELLOW}Warning: @compress only applies to arrays of primitives, ignored on '{data_type} {data_name}'{Colors.RESET}"
+            )
+        else:
+            if "bitpacked" in annotations:
+                print(
+                    f"{Colors.YELLOW}Warning: @bitpacked is ignored on the compressed field '{data_name}'{Colors.RESET}"
+                )
+            return (
+                f"::raisin::CompressedField<_{data_name}_type>{{{data_name}, ::raisin::Compression::{COMPRESSION_CODECS[codec]}, {threshold}}}",
+                f"::raisin::CompressedFieldRef<_{data_name}_type>{{{data_name}}}",
+                f"temp += ::raisin::kCompressedFieldHeaderSize;\n  {default_size}",
+                f"::raisin::Compressed<_{data_name}_type>",
+            )
+    if "bitpacked" in annotations:
+        if data_type == "bool[]":
+            return (
+                f"::raisin::BitPackedBools{{{data_name}}}",
+                data_name,
+                f"temp += sizeof(uint32_t) + ({data_name}.size() + 7) / 8;",
+                f"_{data_name}_type",
+            )
+        print(
+            f"{Colors.YELLOW}Warning: @bitpacked only applies to bool[] fields, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+    return data_name, data_name, default_size, f"_{data_name}_type"
+
+
+def eigen_vector_type(data_type, data_name, base_type):
+    """
+    Return the Eigen type of a 'T[N] name @eigen' or 'T[] name @eigen' member of numbers,
+    or None with a warning if the field is not such an array.
+    """
+    element_type = data_type.split("[", 1)[0]
+    if (
+        not data_type.endswith("]")
+        or element_type not in TYPE_MAPPING
+        or element_type == "bool"
+        or TYPE_MAPPING[element_type] in STRING_TYPES
+    ):
+        print(
+            f"{Colors.YELLOW}Warning: @eigen only applies to arrays of numbers, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+        return None
+    if match := re.match(r"[a-zA-Z0-9_]+\[(\d+)\]$", data_type):
+        return f"Eigen::Matrix<{base_type}, {match.group(1)}, 1, Eigen::DontAlign>"
+    return f"Eigen::Matrix<{base_type}, Eigen::Dynamic, 1>"
+
+
+def struct_of_arrays_columns(data_type, data_name, transformed_type, base_type, element_project):
+    """
+    Return the definition of the columns struct of a 'T[] name @soa' member, or None with a warning if
+    T is not a message made of numeric and bool fields. The struct keeps one std::vector per field of T
+    and copies each of them with a single memcpy when serialized.
+    """
+    element_fields = g.message_fields.get((element_project, base_type))
+    if not data_type.endswith("[]") or element_fields is None:
+        print(
+            f"{Colors.YELLOW}Warning: @soa only applies to unbounded arrays of messages, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+        return None
+
+    columns = []
+    for field_type, field_name, _ in element_fields:
+        if field_type not in TYPE_MAPPING or TYPE_MAPPING[field_type] in STRING_TYPES:
+            print(
+                f"{Colors.YELLOW}Warning: @soa needs every field of {base_type} to be a number or bool, "
+                f"ignored on '{data_type} {data_name}'{Colors.RESET}"
+            )
+            return None
+        field_name = re.sub(
+            r"(?<!^)(?=[A-Z][a-z]|(?<=[a-z])[A-Z]|(?<=[0-9])(?=[A-Z]))", "_", field_name
+        ).lower()
+        field_name = field_name.replace("__", "_")
+        column_type = "uint8_t" if field_type == "bool" else TYPE_MAPPING[field_type]
+        columns.append((column_type, field_name))
+    if not columns:
+        print(
+            f"{Colors.YELLOW}Warning: @soa needs {base_type} to have fields, ignored on '{data_type} {data_name}'{Colors.RESET}"
+        )
+        return None
+
+    struct_name = f"_{data_name}_columns"
+    value_type = transformed_type[len("std::vector<"):-1]
+    first = columns[0][1]
+
+    def each(statement):
+        return " ".join(statement.format(column=name) for _, name in columns)
+
+    lines = [
+        f"/// structure-of-arrays storage of {data_type} {data_name}. element i is the i-th value of every column",
+        f"struct {struct_name} {{",
+        f"  using value_type = {value_type};",
+        f"  static constexpr size_t kRowSize = {' + '.join(f'sizeof({column_type})' for column_type, _ in columns)};",
+        "",
+    ]
+    lines += [f"  std::vector<{column_type}> {name};" for column_type, name in columns]
+    lines += [
+        "",
+        f"  [[nodiscard]] inline size_t size() const {{ return {first}.size(); }}",
+        f"  [[nodiscard]] inline bool empty() const {{ return {first}.empty(); }}",
+        f"  inline void resize(size_t n) {{ {each('{column}.resize(n);')} }}",
+        f"  inline void reserve(size_t n) {{ {each('{column}.reserve(n);')} }}",
+        "  inline void clear() { resize(0); }",
+        "",
+        "  [[nodiscard]] inline value_type operator[](size_t i) const {",
+        "    value_type v;",
+        f"    {each('v.{column} = {column}[i];')}",
+        "    return v;",
+        "  }",
+        f"  inline void set(size_t i, const value_type& v) {{ {each('{column}[i] = v.{column};')} }}",
+        f"  inline void push_back(const value_type& v) {{ {each('{column}.push_back(v.{column});')} }}",
+        "",
+        "  [[nodiscard]] inline std::vector<value_type> toVector() const {",
+        "    std::vector<value_type> val(size());",
+        "    for (size_t i = 0; i < val.size(); i++) val[i] = (*this)[i];",
+        "    return val;",
+        "  }",
+        "",
+        "  inline void assign(const std::vector<value_type>& val) {",
+        "    resize(val.size());",
+        "    for (size_t i = 0; i < val.size(); i++) set(i, val[i]);",
+        "  }",
+        "",
+        f"  bool operator==(const {struct_name}& other) const {{",
+        f"    return {' && '.join(f'{name} == other.{name}' for _, name in columns)};",
+        "  }",
+        "",
+        "  [[nodiscard]] inline uint32_t getSize() const {",
+        "    return static_cast<uint32_t>(sizeof(uint32_t) + size() * kRowSize);",
+        "  }",
+        "",
+        "  inline unsigned char* setBuffer(unsigned char* buffer) const {",
+        "    const size_t count = size();",
+        "    buffer = ::raisin::setBuffer(buffer, static_cast<uint32_t>(count));",
+    ]
+    lines += [f"    buffer = ::raisin::internal::setColumn(buffer, {name}, count);" for _, name in columns]
+    lines += [
+        "    return buffer;",
+        "  }",
+        "",
+        "  inline const unsigned char* getBuffer(const unsigned char* buffer) {",
+        "    uint32_t count;",
+        "    buffer = ::raisin::getBuffer(buffer, count);",
+    ]
+    lines += [f"    buffer = ::raisin::internal::getColumn(buffer, {name}, count);" for _, name in columns]
+    lines += [
+        "    return buffer;",
+        "  }",
+        "",
+        "  inline bool getBuffer(BufferReader& reader) {",
+        "    uint32_t count;",
+        "    if (!::raisin::getBuffer(reader, count)) return false;",
+        "    if (size_t(count) * kRowSize > reader.getRemaining()) {",
+        "      reader.fail();",
+        "      return false;",
+        "    }",
+    ]
+    lines += [f"    ::raisin::internal::getColumn(reader, {name}, count);" for _, name in columns]
+    lines += [
+        "    return reader.ok();",
+        "  }",
+        "",
+        "  inline void appendSegments(SegmentWriter& writer) const {",
+        "    const size_t count = size();",
+        "    const uint32_t wireCount = static_cast<uint32_t>(count);",
+        "    writer.append(&wireCount, sizeof(uint32_t));",
+    ]
+    lines += [f"    ::raisin::internal::appendColumn(writer, {name}, count);" for _, name in columns]
+    lines += ["  }", "};"]
+    # members are joined with a two-space indent after the first line
+    return "\n".join(f"  {line}" if line else "" for line in lines)[2:]
+
+
 def create_action_file(action_file, project_directory, install_dir):
     """
     Create a message file based on the template, replacing '@@MESSAGE_NAME@@' with the message file name.
@@ -848,6 +1207,15 @@ def create_action_file(action_file, project_directory, install_dir):
     message_content = message_content.replace("@@MESSAGE_NAME@@", class_name)
     message_content = message_content.replace("@@PROJECT_NAME@@", project_name)
 
+    # Hash the layouts of the goal, result and feedback parts
+    action_definition = "---".join(
+        structural_definition(read_interface_fields(part), project_name)
+        for part in Path(action_file).read_text().split("---")
+    )
+    message_content = message_content.replace(
+        "@@TYPE_HASH@@", type_hash_literal(action_definition)
+    )
+
     # Create the message file in the <g.script_directory>/include/<project_directory>/msg directory
     snake_str = re.sub(
         r"(?<!^)(?=[A-Z][a-z]|(?<=[a-z])[A-Z]|(?<=[0-9])(?=[A-Z]))", "_", message_name
@@ -855,8 +1223,7 @@ def create_action_file(action_file, project_directory, install_dir):
     snake_str = snake_str.replace("__", "_")
     output_path = os.path.join(include_project_msg_dir, f"{snake_str}.hpp")
 
-    with open(output_path, "w") as output_file:
-        output_file.write(message_content)
+    write_if_changed(output_path, message_content)
 
     ### create other interface files
     action_path = Path(action_file)
@@ -922,6 +1289,113 @@ def create_action_file(action_file, project_directory, install_dir):
     file_path.write_text(feedback_message_content)
 
 
+def read_interface_fields(content):
+    """
+    Return the (data_type, data_name, annotations) fields of .msg content or of one part of a .srv/.action file.
+    Constants and separator lines are skipped.
+    """
+    fields = []
+    for line in content.splitlines():
+        line = line.split("#", 1)[0].strip()
+        if not line or line[0] == "-":
+            continue
+        line, annotations = parse_field_annotations(line)
+        parts = line.split()
+        if len(parts) < 4 and "=" not in line.split(" ", 1)[1]:
+            fields.append((parts[0], parts[1], annotations))
+    return fields
+
+
+def read_message_fields(msg_files):
+    """Return a dict mapping (package, message) to the fields of each .msg file."""
+    fields = {}
+    for msg_file in msg_files:
+        package = os.path.basename(Path(msg_file).parent.parent)
+        message = os.path.basename(msg_file).replace(".msg", "")
+        fields[(package, message)] = read_interface_fields(Path(msg_file).read_text())
+    return fields
+
+
+# annotations that change the bytes on the wire. @eigen and @bitpacked only change the C++ member type or an
+# encoding every decoder accepts, so peers that disagree on them still interoperate and they stay out of kTypeHash
+WIRE_FORMAT_ANNOTATIONS = ("compress", "soa")
+
+
+def structural_definition(fields, package, stack=()):
+    """
+    Return a canonical string of the recursive field layout (names, types, array sizes and the annotations in
+    WIRE_FORMAT_ANNOTATIONS). Nested messages known from g.message_fields are expanded, unknown ones are kept by name.
+    """
+    definition = []
+    for data_type, data_name, annotations in fields:
+        match = re.match(r"(.*?)(\[\d*\])?$", data_type)
+        base_type, array_suffix = match.group(1), match.group(2) or ""
+        if base_type not in TYPE_MAPPING:
+            nested_package, nested_type = package, base_type
+            if "/" in base_type:
+                nested_package, nested_type = base_type.rsplit("/", 1)
+            elif base_type == "Header":
+                nested_package = "std_msgs"
+            key = (nested_package, nested_type)
+            if key in g.message_fields and key not in stack:
+                base_type = "{" + structural_definition(g.message_fields[key], nested_package, stack + (key,)) + "}"
+            else:
+                base_type = f"{nested_package}/{nested_type}"
+        annotation_string = "".join(
+            f"@{name}({annotations[name]})" for name in sorted(annotations) if name in WIRE_FORMAT_ANNOTATIONS
+        )
+        definition.append(f"{base_type}{array_suffix} {data_name}{annotation_string};")
+    return "".join(definition)
+
+
+def type_hash_literal(definition):
+    """Return the 64-bit FNV-1a hash of a structural definition as a C++ literal."""
+    value = 0xCBF29CE484222325
+    for byte in definition.encode():
+        value = ((value ^ byte) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return f"0x{value:016x}ull"
+
+
+def find_fixed_size_messages(msg_files):
+    """
+    Return the set of (package, message) pairs whose fields all have a fixed wire size:
+    non-string primitives, T[N] arrays of those, and nested messages that are fixed-size themselves.
+    Nested types that are not among msg_files are treated as variable-size.
+    """
+    fields = read_message_fields(msg_files)
+
+    def field_key(data_type, package, annotations):
+        """Return None for a fixed-size primitive, False for a variable-size field, or the nested message key."""
+        if "compress" in annotations:
+            return False
+        if "/" in data_type:
+            package, data_type = data_type.rsplit("/", 1)
+        if match := re.match(r"([a-zA-Z0-9_]+)\[(\d+)\]$", data_type):
+            data_type = match.group(1)
+        elif data_type.endswith("]"):
+            return False
+        if data_type in TYPE_MAPPING:
+            return False if TYPE_MAPPING[data_type] in STRING_TYPES else None
+        if data_type == "Header":
+            package = "std_msgs"
+        return (package, data_type)
+
+    # start optimistic and drop messages until the set is stable, which also handles nesting order
+    fixed = set(fields.keys())
+    changed = True
+    while changed:
+        changed = False
+        for key in list(fixed):
+            for data_type, _, annotations in fields[key]:
+                nested = field_key(data_type, key[0], annotations)
+                if nested is False or (nested is not None and nested not in fixed):
+                    fixed.discard(key)
+                    changed = True
+                    break
+
+    return fixed
+
+
 def create_message_file(msg_file, project_directory, install_dir):
     """
     Create a message file based on the template, replacing '@@MESSAGE_NAME@@' with the message file name.
@@ -936,9 +1410,10 @@ def create_message_file(msg_file, project_directory, install_dir):
     include_project_msg_dir = os.path.join(
         g.script_directory, "generated", "include", project_name, "msg"
     )
-    destination_file = os.path.join(install_dir, "messages", project_name, "msg", "")
-    os.makedirs(destination_file, exist_ok=True)
-    shutil.copy2(msg_file, destination_file)
+    if is_installed_interface(msg_file):
+        destination_file = os.path.join(install_dir, "messages", project_name, "msg", "")
+        os.makedirs(destination_file, exist_ok=True)
+        shutil.copy2(msg_file, destination_file)
 
     # Delete the entire include directory before generating new files
     os.makedirs(include_project_msg_dir, exist_ok=True)  # Recreate it
@@ -960,7 +1435,12 @@ def create_message_file(msg_file, project_directory, install_dir):
     includes = []
     members = []
     buffer_members = []
+    write_members = []
+    read_members = []
+    wire_types = []
     buffer_size = []
+    # Eigen vectors of different sizes cannot be compared with operator==
+    eigen_members = set()
 
     for line in lines:
         line = line.strip()
@@ -972,6 +1452,7 @@ def create_message_file(msg_file, project_directory, install_dir):
         if not line:
             continue
 
+        line, annotations = parse_field_annotations(line)
         parts = line.split()
         parts_in_two = line.split(" ", 1)
 
@@ -999,6 +1480,12 @@ def create_message_file(msg_file, project_directory, install_dir):
                 if not subproject_path:
                     subproject_path = project_name
 
+                nested_project = subproject_path if data_type != "Header" else "std_msgs"
+                if nested_project != project_name:
+                    g.message_library_dependencies.setdefault(project_name, set()).add(
+                        nested_project
+                    )
+
                 if data_type != "Header":
                     snake_str = re.sub(
                         r"(?<!^)(?=[A-Z][a-z]|(?<=[a-z])[A-Z]|(?<=[0-9])(?=[A-Z]))",
@@ -1012,46 +1499,80 @@ def create_message_file(msg_file, project_directory, install_dir):
                 else:
                     includes.append(f'#include "../../std_msgs/msg/header.hpp"')
 
+            if "soa" in annotations:
+                columns = struct_of_arrays_columns(
+                    data_type, data_name, transformed_type, base_type, subproject_path
+                )
+                if columns:
+                    members.append(columns)
+                    transformed_type = f"_{data_name}_columns"
+                else:
+                    del annotations["soa"]
+
+            if "eigen" in annotations:
+                eigen_type = eigen_vector_type(data_type, data_name, base_type)
+                if eigen_type:
+                    transformed_type = eigen_type
+                    eigen_members.add(data_name)
+                    if "#include <Eigen/Core>" not in includes:
+                        includes.append("#include <Eigen/Core>")
+                else:
+                    del annotations["eigen"]
+
             members.append(f"using _{data_name}_type = {transformed_type};")
             if len(parts) == 3:
                 members.append(f"{transformed_type} {data_name} = {initial_value};")
+            elif data_name in eigen_members and not data_type.endswith("[]"):
+                # fixed-size Eigen vectors are not value-initialized like std::array
+                members.append(f"{transformed_type} {data_name} = _{data_name}_type::Zero();")
             else:
                 members.append(f"{transformed_type} {data_name};")
             buffer_members.append(data_name)
-
-            if transformed_type.startswith(
-                "std::vector"
-            ) or transformed_type.startswith("std::array"):
-                if base_type in STRING_TYPES:
-                    buffer_size.append(
-                        f"temp += sizeof(uint32_t); \n for (const auto& v : {data_name}) temp += sizeof(uint32_t) + v.size();"
-                    )
-                elif base_type in TYPE_MAPPING.values():
-                    buffer_size.append(
-                        f"temp += {data_name}.size() * sizeof({data_name});"
-                    )
-                else:
-                    buffer_size.append(
-                        f"for (const auto& v : {data_name}) temp += v.getSize();"
-                    )
-            else:
-                if transformed_type in STRING_TYPES:
-                    buffer_size.append(
-                        f"temp += sizeof(uint32_t) + {data_name}.size();"
-                    )
-                elif (
-                    transformed_type in TYPE_MAPPING.values()
-                    and transformed_type != "std::string"
-                    and transformed_type != "std::u16string"
-                ):
-                    buffer_size.append(f"temp += sizeof({data_name});")
-                else:
-                    buffer_size.append(f"temp += {data_name}.getSize();")
+            write_member, read_member, member_size, wire_type = annotated_member_codec(
+                data_type, data_name, transformed_type, base_type, annotations
+            )
+            add_codec_include(includes, write_member)
+            write_members.append(write_member)
+            read_members.append(read_member)
+            buffer_size.append(member_size)
+            wire_types.append(wire_type)
 
         elif "=" in line:
             parts = line.split(" ", 1)
             members.append(f"static constexpr {TYPE_MAPPING[parts[0]]} {parts[1]};")
 
+    message_content = message_content.replace(
+        "@@TYPE_HASH@@",
+        type_hash_literal(
+            structural_definition(
+                read_interface_fields("".join(lines)),
+                project_name,
+                ((project_name, message_name),),
+            )
+        ),
+    )
+
+    # Fixed-size messages get a compile-time size
+    if (project_name, message_name) in g.fixed_size_messages:
+        field_sizes = [f"::raisin::FixedWireSize<_{bm}_type>::size" for bm in buffer_members]
+        field_checks = [f"::raisin::FixedWireSize<_{bm}_type>::value" for bm in buffer_members]
+        fixed_size_declaration = ""
+        if field_checks:
+            fixed_size_declaration += f"static_assert({' && '.join(field_checks)}, \"every field must have a fixed wire size\");\n"
+        fixed_size_declaration += f"static constexpr uint32_t kSerializedSize = {' + '.join(field_sizes) or '0'};\n"
+        buffer_size = ["temp += kSerializedSize;"]
+        get_size_specifier = "constexpr"
+    else:
+        fixed_size_declaration = ""
+        get_size_specifier = "inline"
+
+    message_content = message_content.replace(
+        "@@FIXED_SIZE_DECLARATION@@", fixed_size_declaration
+    )
+    message_content = message_content.replace(
+        "@@GET_SIZE_SPECIFIER@@", get_size_specifier
+    )
+
     # Insert includes and members into the template
     message_content = message_content.replace("@@INCLUDE_PATH@@", "\n".join(includes))
     message_content = message_content.replace("@@MEMBERS@@", "\n  ".join(members))
@@ -1063,18 +1584,46 @@ def create_message_file(msg_file, project_directory, install_dir):
     get_buffer_member_string = ""
     equal_buffer_member_string = ""
 
-    for bm in buffer_members:
-        set_buffer_member_string += f"::raisin::setBuffer(buffer, {bm});\n"
+    for wm in write_members:
+        set_buffer_member_string += f"::raisin::setBuffer(buffer, {wm});\n"
 
-    for bm in buffer_members:
-        get_buffer_member_string += f"temp = ::raisin::getBuffer(temp, {bm});\n"
+    for rm in read_members:
+        get_buffer_member_string += f"temp = ::raisin::getBuffer(temp, {rm});\n"
+
+    get_reader_member_string = ""
+    for rm in read_members:
+        get_reader_member_string += f"::raisin::getBuffer(reader, {rm});\n"
+
+    append_segments_member_string = ""
+    for wm in write_members:
+        append_segments_member_string += f"::raisin::appendSegments(writer, {wm});\n"
+
+    def member_equal(bm, other):
+        if bm in eigen_members:
+            return f"::raisin::eigenVectorsEqual(this->{bm}, {other}.{bm})"
+        return f"this->{bm} == {other}.{bm}"
 
     for bm in buffer_members:
-        equal_buffer_member_string += f"&& this->{bm} == other.{bm} \n"
+        equal_buffer_member_string += f"&& {member_equal(bm, 'other')} \n"
+
+    set_delta_member_string = ""
+    apply_delta_member_string = ""
+    apply_delta_reader_member_string = ""
+    for i, (bm, wm, rm) in enumerate(zip(buffer_members, write_members, read_members)):
+        mask_test = f"fieldMask[{i // 8}] & {1 << (i % 8)}"
+        set_delta_member_string += (
+            f"if (isKeyframe || !({member_equal(bm, 'previousMsg')})) {{\n"
+            f"    fieldMask[{i // 8}] |= {1 << (i % 8)};\n"
+            f"    ::raisin::setBuffer(buffer, {wm});\n"
+            f"  }}\n  "
+        )
+        apply_delta_member_string += (
+            f"if ({mask_test}) temp = ::raisin::getBuffer(temp, {rm});\n  "
+        )
+        apply_delta_reader_member_string += (
+            f"if ({mask_test}) ::raisin::getBuffer(reader, {rm});\n  "
+        )
 
-    message_content = message_content.replace(
-        "@@SET_BUFFER_MEMBERS@@", set_buffer_member_string
-    )
     modified_set_buffer_member_string = "\n".join(
         "buffer = " + line for line in set_buffer_member_string.splitlines()
     )
@@ -1084,9 +1633,46 @@ def create_message_file(msg_file, project_directory, install_dir):
     message_content = message_content.replace(
         "@@GET_BUFFER_MEMBERS@@", get_buffer_member_string
     )
+    message_content = message_content.replace(
+        "@@GET_READER_MEMBERS@@", get_reader_member_string
+    )
+    message_content = message_content.replace(
+        "@@APPEND_SEGMENTS_MEMBERS@@", append_segments_member_string
+    )
     message_content = message_content.replace(
         "@@EQUAL_BUFFER_MEMBERS@@", equal_buffer_member_string
     )
+    message_content = message_content.replace(
+        "@@SET_DELTA_MEMBERS@@", set_delta_member_string
+    )
+    message_content = message_content.replace(
+        "@@APPLY_DELTA_MEMBERS@@", apply_delta_member_string
+    )
+    message_content = message_content.replace(
+        "@@APPLY_DELTA_READER_MEMBERS@@", apply_delta_reader_member_string
+    )
+
+    view_offsets = []
+    view_accessors = []
+    for i, (bm, wire_type) in enumerate(zip(buffer_members, wire_types)):
+        view_offsets.append(
+            f"offset_[{i}] = static_cast<uint32_t>(temp - buffer);\n"
+            f"    temp = ::raisin::ViewTraits<{wire_type}>::skip(temp);"
+        )
+        view_accessors.append(
+            f"[[nodiscard]] inline ::raisin::ViewTraits<{wire_type}>::type {bm}() const {{\n"
+            f"    return ::raisin::ViewTraits<{wire_type}>::view(begin_ + offset_[{i}]);\n"
+            f"  }}"
+        )
+    message_content = message_content.replace(
+        "@@VIEW_OFFSETS@@", "\n    ".join(view_offsets)
+    )
+    message_content = message_content.replace(
+        "@@VIEW_ACCESSORS@@", "\n\n  ".join(view_accessors)
+    )
+    message_content = message_content.replace(
+        "@@VIEW_FIELD_COUNT@@", str(len(buffer_members))
+    )
 
     # Create the message file in the <g.script_directory>/include/<project_directory>/msg directory
     snake_str = re.sub(
@@ -1095,12 +1681,57 @@ def create_message_file(msg_file, project_directory, install_dir):
     snake_str = snake_str.replace("__", "_")
     output_path = os.path.join(include_project_msg_dir, f"{snake_str}.hpp")
 
-    with open(output_path, "w") as output_file:
-        output_file.write(message_content)
+    # In codec library mode the codec bodies are only compiled by a generated source of <project>_msgs
+    implementation_macro = f"RAISIN_{project_name}_msg_{class_name}_CODEC_IMPLEMENTATION"
+    if g.message_codec_library:
+        message_content = message_content.replace(
+            "@@CODEC_IMPLEMENTATION_BEGIN@@", f"#ifdef {implementation_macro}"
+        )
+        message_content = message_content.replace("@@CODEC_IMPLEMENTATION_END@@", "#endif")
+        message_content = message_content.replace("@@CODEC_SPECIFIER@@ ", "")
+        write_codec_source(project_name, snake_str, implementation_macro)
+    else:
+        message_content = message_content.replace("@@CODEC_IMPLEMENTATION_BEGIN@@\n", "")
+        message_content = message_content.replace("@@CODEC_IMPLEMENTATION_END@@\n", "")
+        message_content = message_content.replace("@@CODEC_SPECIFIER@@", "inline")
+
+    write_if_changed(output_path, message_content)
 
     # print(f"Created message file: {output_path}")
 
 
+def write_codec_source(project_name, snake_str, implementation_macro):
+    """
+    Write the translation unit that compiles the codec of one message into <project>_msgs.
+    The source is saved in <g.script_directory>/generated/src/<project_name>/msg.
+    """
+    source_dir = os.path.join(g.script_directory, "generated", "src", project_name, "msg")
+    os.makedirs(source_dir, exist_ok=True)
+    source_path = os.path.join(source_dir, f"{snake_str}.cpp")
+
+    write_if_changed(
+        source_path,
+        f"#define {implementation_macro}\n"
+        f'#include "{project_name}/msg/{snake_str}.hpp"\n',
+    )
+
+    g.message_library_sources.setdefault(project_name, []).append(
+        source_path.replace("\\", "/")
+    )
+
+
+def get_configuration_flag(key):
+    """
+    Reads an on/off option such as 'message_codec_library' from configuration_setting.yaml. Off unless set to true.
+    """
+    config_path = Path(g.script_directory) / "configuration_setting.yaml"
+    if not config_path.is_file():
+        return False
+    with open(config_path, "r") as f:
+        config = yaml.safe_load(f) or {}
+    return bool(config.get(key, False))
+
+
 def get_ubuntu_version():
     with open("/etc/os-release") as f:
         for line in f:
@@ -1484,7 +2115,7 @@ def deploy_install_packages():
             shutil.copytree(source_dir, final_dest_dir, dirs_exist_ok=True)
 
             if (p / "generated").is_dir():
-                shutil.copytree(p / "generated", generated_dest_dir, dirs_exist_ok=True)
+                copy_tree_if_changed(p / "generated", generated_dest_dir)
 
             if (p / "install_dependencies.sh").is_file():
                 os.makedirs(
@@ -1771,9 +2402,9 @@ def setup(package_name="", build_type="", build_dir=""):
         src_dir = "src/" + package_name
         install_dir = f"release/install/{package_name}/{g.os_type}/{g.os_version}/{g.architecture}/{build_type}"
 
-    delete_directory(
-        os.path.join(g.script_directory, "generated")
-    )  # Delete the whole 'include' directory
+    # 'generated' is kept between runs and only files whose content changed are rewritten,
+    # so an incremental build recompiles just the includers of changed messages
+    g.generated_files = set()
     delete_directory(Path(g.script_directory) / install_dir)
     os.makedirs(Path(g.script_directory) / install_dir, exist_ok=True)
 
@@ -1792,11 +2423,26 @@ def setup(package_name="", build_type="", build_dir=""):
     for action_file in action_files:
         create_action_file(action_file, Path(action_file).parent.parent, install_dir)
 
+    # The benchmark messages are only generated when the benchmark is built
+    g.serialization_benchmark = get_configuration_flag("serialization_benchmark")
+    interface_directories = ["src", "temp"]
+    if g.serialization_benchmark:
+        interface_directories.append("templates/benchmark")
+    # likewise the messages of the tests
+    g.serialization_tests = get_configuration_flag("serialization_tests")
+    if g.serialization_tests:
+        interface_directories.append("templates/tests")
+
     msg_files, srv_files = find_interface_files(
-        ["src", "temp"], ["msg", "srv"], packages_to_ignore
+        interface_directories, ["msg", "srv"], packages_to_ignore
     )
 
     # Handle .msg files
+    g.message_codec_library = get_configuration_flag("message_codec_library")
+    g.message_library_sources = {}
+    g.message_library_dependencies = {}
+    g.message_fields = read_message_fields(msg_files)
+    g.fixed_size_messages = find_fixed_size_messages(msg_files)
     for msg_file in msg_files:
         create_message_file(msg_file, Path(msg_file).parent.parent, install_dir)
 
@@ -1813,10 +2459,6 @@ def setup(package_name="", build_type="", build_dir=""):
         copy_resource(install_dir)
 
     os.makedirs(os.path.join(g.script_directory, "generated/include"), exist_ok=True)
-    shutil.copy(
-        os.path.join(g.script_directory, "templates", "raisin_serialization_base.hpp"),
-        os.path.join(g.script_directory, "generated/include"),
-    )
 
     # create release tag
     install_release_file = Path(g.script_directory) / "install" / "release.txt"
@@ -1849,26 +2491,44 @@ def setup(package_name="", build_type="", build_dir=""):
     write_data(output_file, merged_data)
     print(f"💾 Wrote git hash file: {output_file}")
 
-    # copy raisin serialization base
-    src_file = os.path.join(
-        g.script_directory, "templates", "raisin_serialization_base.hpp"
-    )
+    # copy raisin serialization base and the opt-in headers next to it
     dest_dir = os.path.join(g.script_directory, "generated", "include")
 
     os.makedirs(dest_dir, exist_ok=True)  # Ensure destination directory exists
-    shutil.copy2(src_file, dest_dir)
+    for src_file in sorted(glob.glob(os.path.join(g.script_directory, "templates", "raisin_*.hpp"))):
+        copy_if_changed(src_file, os.path.join(dest_dir, os.path.basename(src_file)))
 
     os.makedirs(Path(g.script_directory) / "install", exist_ok=True)
 
-    # install generated files
+    # deployed packages copy their generated headers into generated/ as well, so they run before the cleanup
+    deploy_install_packages()
+
+    # remove what a previous setup generated or copied for messages and packages that no longer exist
+    remove_stale_generated_files(
+        os.path.join(g.script_directory, "generated"),
+        os.path.join(g.script_directory, ".generated_files"),
+    )
+
+    # install generated files, except the headers and codec sources of the test and benchmark messages
+    generated_dir = Path(g.script_directory) / "generated"
+    uninstalled_packages = {
+        Path(interface_file).parent.parent.name
+        for interface_file in msg_files + srv_files
+        if not is_installed_interface(interface_file)
+    }
+
+    def ignore_uninstalled_packages(directory, names):
+        if Path(directory).parent != generated_dir:
+            return []
+        return [name for name in names if name in uninstalled_packages]
+
     shutil.copytree(
-        Path(g.script_directory) / "generated",
+        generated_dir,
         Path(g.script_directory) / install_dir / "generated",
+        ignore=ignore_uninstalled_packages,
         dirs_exist_ok=True,
     )
 
-    deploy_install_packages()
-
     shutil.copy2(
         Path(g.script_directory) / "templates/install_dependencies.sh",
         Path(g.script_directory) / "install/install_dependencies.sh",
@@ -7,6 +7,7 @@ Shared utilities used across multiple command modules.
 import os
 import sys
 import yaml
+import hashlib
 import shutil
 import platform
 from pathlib import Path
@@ -80,6 +81,115 @@ def delete_directory(directory):
         shutil.rmtree(directory)
 
 
+def _file_digest(path):
+    """
+    sha256 of a text file with normalized line endings, or None if it does not exist.
+    """
+    try:
+        with open(path, "r", encoding="utf-8", errors="surrogateescape") as f:
+            return hashlib.sha256(f.read().encode("utf-8", errors="surrogateescape")).digest()
+    except FileNotFoundError:
+        return None
+
+
+def write_if_changed(path, content):
+    """
+    Write content to a generated file unless the file already holds the same content, compared by hash.
+    Unchanged files keep their modification time, so an incremental build does not recompile their includers.
+
+    Args:
+        path: Path of the file to write
+        content: Text content of the file
+
+    Returns:
+        bool: True if the file was written
+    """
+    g.generated_files.add(os.path.normpath(str(path)))
+    digest = hashlib.sha256(content.encode("utf-8", errors="surrogateescape")).digest()
+    if _file_digest(path) == digest:
+        return False
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w", encoding="utf-8", errors="surrogateescape") as f:
+        f.write(content)
+    return True
+
+
+def copy_if_changed(src, dst):
+    """
+    Copy a text file like write_if_changed. dst is the destination file, not a directory.
+
+    Returns:
+        bool: True if the file was written
+    """
+    with open(src, "r", encoding="utf-8", errors="surrogateescape") as f:
+        return write_if_changed(dst, f.read())
+
+
+def copy_tree_if_changed(src, dst):
+    """
+    Copy a directory tree into a generated directory, file by file. Like write_if_changed, each copied file
+    is recorded, so remove_stale_generated_files deletes it once its source is gone, and files whose bytes
+    did not change keep their modification time. Files are compared as bytes, so binary files are copied as is.
+
+    Args:
+        src: Source directory
+        dst: Destination directory, merged with what is already there
+    """
+    for root, _, files in os.walk(src):
+        target_root = os.path.join(dst, os.path.relpath(root, src))
+        for filename in files:
+            source_path = os.path.join(root, filename)
+            target_path = os.path.normpath(os.path.join(target_root, filename))
+            g.generated_files.add(target_path)
+            with open(source_path, "rb") as f:
+                content = f.read()
+            try:
+                with open(target_path, "rb") as f:
+                    if f.read() == content:
+                        continue
+            except FileNotFoundError:
+                pass
+            os.makedirs(target_root, exist_ok=True)
+            with open(target_path, "wb") as f:
+                f.write(content)
+            shutil.copymode(source_path, target_path)
+
+
+def remove_stale_generated_files(directory, manifest_path):
+    """
+    Delete the files that the previous setup generated or copied in directory but this one did not (e.g. of a
+    removed .msg or package), and record the generated files of this run. Files that no setup recorded are
+    left alone.
+
+    Args:
+        directory: The 'generated' directory
+        manifest_path: File listing the generated files, kept outside directory since it is copied around
+    """
+    directory = os.path.normpath(str(directory))
+    current = {path for path in g.generated_files if path.startswith(directory + os.sep)}
+
+    previous = set()
+    if os.path.isfile(manifest_path):
+        with open(manifest_path, "r", encoding="utf-8") as f:
+            previous = {
+                os.path.normpath(os.path.join(directory, line.strip())) for line in f if line.strip()
+            }
+
+    for path in sorted(previous - current):
+        if os.path.isfile(path):
+            os.remove(path)
+        # drop directories left empty, up to the generated directory itself
+        parent = os.path.dirname(path)
+        while parent.startswith(directory + os.sep) and os.path.isdir(parent) and not os.listdir(parent):
+            os.rmdir(parent)
+            parent = os.path.dirname(parent)
+
+    os.makedirs(directory, exist_ok=True)
+    with open(manifest_path, "w", encoding="utf-8") as f:
+        for path in sorted(current):
+            f.write(os.path.relpath(path, directory).replace("\\", "/") + "\n")
+
+
 def is_root():
     """
     Check if the current user is root.
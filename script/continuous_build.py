@@ -8,6 +8,7 @@ from datetime import datetime
 from pathlib import Path
 from tempfile import gettempdir
 import hashlib
+import json
 
 # --- Paths / Config ---
 
@@ -24,6 +25,17 @@ DASHBOARD_PATH = SCRIPT_DIR / 'raionrobotics_ci_dashboard'
 DASHBOARD_README = DASHBOARD_PATH / 'README.md'
 # --------------------------------
 
+# --- Serialization Benchmark ---
+# built when 'serialization_benchmark' is set in configuration_setting.yaml
+CONFIG_FILE = PROJECT_ROOT / 'configuration_setting.yaml'
+BENCHMARK_NAME = 'raisin_serialization_benchmark'
+BENCHMARK_BASELINE = DASHBOARD_PATH / 'serialization_benchmark.json'
+BENCHMARK_SECTION_BEGIN = '<!-- serialization-benchmark -->'
+BENCHMARK_SECTION_END = '<!-- /serialization-benchmark -->'
+# a case regresses if it is this much slower than the baseline, or allocates more
+BENCHMARK_REGRESSION_THRESHOLD = 0.10
+# --------------------------------
+
 
 # ------------- Git helpers -------------
 
@@ -214,6 +226,93 @@ def get_latest_commit_from_source_repo(repo_url_release: str) -> tuple[str | Non
     return sha, source_url, f"origin/{default_branch or 'main'}", method
 
 
+# ------------- Benchmark helpers -------------
+
+def find_benchmark_executable():
+    """Returns the benchmark in the release build directory recorded by CMake, or None if it was not built."""
+    try:
+        with open(CONFIG_FILE, 'r') as f:
+            build_dir = (yaml.safe_load(f) or {}).get('release_build_dir')
+    except (FileNotFoundError, yaml.YAMLError):
+        return None
+    if not build_dir or build_dir == 'None':
+        return None
+    for candidate in (Path(build_dir) / BENCHMARK_NAME, Path(build_dir) / f'{BENCHMARK_NAME}.exe',
+                      Path(build_dir) / 'Release' / f'{BENCHMARK_NAME}.exe'):
+        if candidate.is_file():
+            return candidate
+    return None
+
+
+def run_serialization_benchmark():
+    """Runs the benchmark and returns {case: result}, or None if it is not built or fails."""
+    executable = find_benchmark_executable()
+    if executable is None:
+        print(f"{BENCHMARK_NAME} not found in the release build directory; skipping benchmark.")
+        return None
+    json_path = Path(gettempdir()) / 'raisin_serialization_benchmark.json'
+    if not run_build_command([str(executable), '--json', str(json_path)], PROJECT_ROOT):
+        return None
+    try:
+        with open(json_path, 'r') as f:
+            return {r['name']: r for r in json.load(f)['results']}
+    except (OSError, ValueError, KeyError) as e:
+        print(f"Error reading benchmark results: {e}", file=sys.stderr)
+        return None
+
+
+def load_benchmark_baseline():
+    try:
+        with open(BENCHMARK_BASELINE, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {}
+
+
+def compare_benchmarks(results, baseline):
+    """Returns [(case, result, baseline result or None, regressed)] in the order the benchmark ran."""
+    rows = []
+    for name, result in results.items():
+        base = baseline.get(name)
+        regressed = base is not None and (
+            result['ns_per_op'] > base['ns_per_op'] * (1. + BENCHMARK_REGRESSION_THRESHOLD)
+            or result['allocs_per_op'] > base['allocs_per_op'] + 1e-6
+        )
+        rows.append((name, result, base, regressed))
+    return rows
+
+
+def benchmark_markdown(rows, date_time_utc, commit_sha):
+    lines = [
+        BENCHMARK_SECTION_BEGIN,
+        "## Serialization Benchmark",
+        "",
+        f"*Last Run: `{date_time_utc}` on `{(commit_sha or 'N/A')[:7]}`. "
+        f"Regression: more than {BENCHMARK_REGRESSION_THRESHOLD:.0%} slower than the baseline, or more allocations.*",
+        "",
+        "| Case | ns/op | GB/s | allocs/op | vs. baseline | Status |",
+        "| :--- | ---: | ---: | ---: | ---: | :--- |",
+    ]
+    for name, result, base, regressed in rows:
+        change = "new"
+        if base is not None and base['ns_per_op'] > 0:
+            change = f"{(result['ns_per_op'] / base['ns_per_op'] - 1.):+.1%}"
+        throughput = f"{result['gb_per_s']:.3f}" if result['gb_per_s'] > 0 else "-"
+        status = "❌ **Regression**" if regressed else "✅"
+        lines.append(
+            f"| {name} | {result['ns_per_op']:.1f} | {throughput} | {result['allocs_per_op']:.2f} | {change} | {status} |"
+        )
+    lines.append(BENCHMARK_SECTION_END)
+    return "\n".join(lines)
+
+
+def replace_benchmark_section(content, section):
+    pattern = re.compile(re.escape(BENCHMARK_SECTION_BEGIN) + r".*?" + re.escape(BENCHMARK_SECTION_END), re.DOTALL)
+    if pattern.search(content):
+        return pattern.sub(lambda _: section, content)
+    return content.rstrip("\n") + "\n\n" + section + "\n"
+
+
 # ------------- Build sequence -------------
 
 class BuildSequence:
@@ -223,6 +322,7 @@ class BuildSequence:
         self.python_exe = sys.executable
         self.working_dir = PROJECT_ROOT
         self.master_sha = "N/A"
+        self.benchmark_results = None  # {case: result} of the release build
 
     def _run_and_store(self, command, project_name, commit_sha, build_type):
         success = run_build_command(command, self.working_dir)
@@ -266,6 +366,20 @@ class BuildSequence:
             date_time = datetime.utcnow().strftime("%Y-%m-%d %H:%M:%S")
             date_time_utc = f"{date_time} UTC"
 
+            # compare against the baseline after pulling, so it is the latest accepted one
+            benchmark_section = None
+            if self.benchmark_results:
+                benchmark_rows = compare_benchmarks(self.benchmark_results, load_benchmark_baseline())
+                num_regressions = sum(1 for row in benchmark_rows if row[3])
+                benchmark_section = benchmark_markdown(benchmark_rows, date_time_utc, self.master_sha)
+                status_emoji = (f"❌ **Failure** ({num_regressions} regressions)" if num_regressions
+                                else "✅ **Success**")
+                self.results.append(("**SERIALIZATION BENCHMARK**", status_emoji, self.master_sha, "benchmark"))
+                # the baseline only moves forward when nothing regressed
+                if num_regressions == 0:
+                    with open(BENCHMARK_BASELINE, 'w', encoding='utf-8') as f:
+                        json.dump(self.benchmark_results, f, indent=2)
+
             new_rows = []
             for (project_name, status_emoji, commit_sha, build_type) in self.results:
                 commit_sha_short = (commit_sha or "N/A")[:7]
@@ -277,6 +391,8 @@ class BuildSequence:
 
             content = re.sub(r"\*Last Update:\s*`[^`]*`\*", f"*Last Update: `{date_time_utc}`*", content)
             content = self._insert_rows_into_markdown(content, all_new_rows)
+            if benchmark_section:
+                content = replace_benchmark_section(content, benchmark_section)
 
             with open(DASHBOARD_README, 'w', encoding='utf-8') as f:
                 f.write(content)
@@ -290,6 +406,8 @@ class BuildSequence:
             print("Committing and pushing dashboard update...")
             if not run_git_command(['add', 'README.md'], cwd=DASHBOARD_PATH):
                 return
+            if BENCHMARK_BASELINE.exists() and not run_git_command(['add', BENCHMARK_BASELINE.name], cwd=DASHBOARD_PATH):
+                return
 
             num_success = sum(1 for r in self.results if "Success" in r[1])
             num_fail = len(self.results) - num_success
@@ -334,6 +452,9 @@ class BuildSequence:
             print("Build 'release install' failed. Aborting.", file=sys.stderr)
             return
 
+        # 3.1) Serialization benchmark of the release build, compared when reporting
+        self.benchmark_results = run_serialization_benchmark()
+
         # 4) Release Release (Per-package)
         for package in self.package_names:
             if package == 'raisin_third_party_common':
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Reads signals from a log written by AsyncColumnarLogger / ColumnarLogWriter (raisin_columnar_log.hpp).
+
+The file is memory-mapped and only the blocks of the requested columns are touched, so a single signal of an
+hour-long log is read without decoding the others.
+
+usage: read_columnar_log.py LOG            list the columns
+       read_columnar_log.py LOG NAME...    print the rows of the given columns as CSV
+"""
+import mmap
+import struct
+import sys
+
+MAGIC = b'RSNCLOG1'
+
+
+class ColumnarLog:
+    def __init__(self, path):
+        self._file = open(path, 'rb')
+        self._data = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+        if self._data[:8] != MAGIC:
+            raise ValueError(f"{path} is not a columnar log")
+        column_count, header_size = struct.unpack_from('<II', self._data, 8)
+        self.columns = []  # (name, element count, offset in a row)
+        offset, row_size = 16, 0
+        for _ in range(column_count):
+            element_count, name_length = struct.unpack_from('<IH', self._data, offset)
+            name = self._data[offset + 6:offset + 6 + name_length].decode()
+            self.columns.append((name, element_count, row_size))
+            row_size += element_count
+            offset += 6 + name_length
+        self.row_size = row_size
+        self._blocks = []  # (row count, offset of the first value)
+        offset = header_size
+        while offset + 8 <= len(self._data):
+            (row_count,) = struct.unpack_from('<I', self._data, offset)
+            self._blocks.append((row_count, offset + 8))
+            offset += 8 + row_count * row_size * 8
+
+    def close(self):
+        self._data.close()
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def names(self):
+        return [name for name, _, _ in self.columns]
+
+    def row_count(self):
+        return sum(row_count for row_count, _ in self._blocks)
+
+    def read(self, name):
+        """Returns the rows of a column, each a tuple of its element count values."""
+        for column_name, element_count, row_offset in self.columns:
+            if column_name == name:
+                break
+        else:
+            raise KeyError(name)
+        rows = []
+        for row_count, offset in self._blocks:
+            values = struct.unpack_from(f'<{row_count * element_count}d', self._data,
+                                        offset + row_count * row_offset * 8)
+            rows.extend(values[i:i + element_count] for i in range(0, len(values), element_count))
+        return rows
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__.strip().split('\n\n')[-1])
+        return 2
+    with ColumnarLog(sys.argv[1]) as log:
+        if len(sys.argv) == 2:
+            print(f"{log.row_count()} rows")
+            for name, element_count, _ in log.columns:
+                print(f"  {name}[{element_count}]")
+            return 0
+        columns = [log.read(name) for name in sys.argv[2:]]
+        print(','.join(sys.argv[2:]))
+        for row in zip(*columns):
+            print(','.join(' '.join(repr(v) for v in values) for values in row))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <array>
 #include <memory>
 #include <cstdint>
@@ -22,6 +23,7 @@
 #include "action_msgs/msg/goal_status.hpp"
 #include "action_msgs/msg/goal_status_array.hpp"
 #include "action_msgs/srv/cancel_goal.hpp"
+#include "../../raisin_conflation.hpp"
 
 namespace raisin {
 namespace @@PROJECT_NAME@@::action {
@@ -29,8 +31,11 @@ namespace @@PROJECT_NAME@@::action {
 class @@MESSAGE_NAME@@ {
 public:
 
+static constexpr std::string_view kDataType = "@@PROJECT_NAME@@::action::@@MESSAGE_NAME@@";
+static constexpr uint64_t kTypeHash = @@TYPE_HASH@@;
+
 inline static std::string getDataType() {
-  return "@@PROJECT_NAME@@::action::@@MESSAGE_NAME@@";
+  return std::string(kDataType);
 }
 
 using Goal = @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@Goal;
@@ -43,6 +48,10 @@ using FeedbackMessage = @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@FeedbackMessage;
 using GoalStatus = action_msgs::msg::GoalStatus;
 using GoalStatusMessage = action_msgs::msg::GoalStatusArray;
 
+/// conflating QoS for feedback (per goal) and status, whose superseded messages are worthless
+using FeedbackQueue = ::raisin::ConflatingQueue<unique_identifier_msgs::msg::UUID, FeedbackMessage>;
+using GoalStatusQueue = ::raisin::ConflatingQueue<uint8_t, GoalStatusMessage>;
+
 using ConstSharedPtr = std::shared_ptr<const @@PROJECT_NAME@@::action::@@MESSAGE_NAME@@>;
 using SharedPtr = std::shared_ptr<@@PROJECT_NAME@@::action::@@MESSAGE_NAME@@>;
 using ConstUniquePtr = std::unique_ptr<const @@PROJECT_NAME@@::action::@@MESSAGE_NAME@@>;
@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <array>
 #include <memory>
 #include <cstdint>
@@ -29,41 +30,163 @@ bool operator==(const @@MESSAGE_NAME@@& other) const {
 }
 
 inline void setBuffer(std::vector<unsigned char> &buffer) const {
-  @@SET_BUFFER_MEMBERS@@
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + getSize());
+  buffer.resize(setBuffer(buffer.data() + originalSize) - buffer.data());
 }
 
-inline unsigned char* setBuffer(unsigned char* buffer) const {
-  @@SET_BUFFER_MEMBERS2@@
-  return buffer;
-}
+unsigned char* setBuffer(unsigned char* buffer) const;
 
-inline const unsigned char *getBuffer(const unsigned char *buffer) {
-  const unsigned char* temp = buffer;
-  @@GET_BUFFER_MEMBERS@@
-  return temp;
-}
+const unsigned char *getBuffer(const unsigned char *buffer);
 
 inline const unsigned char *getBuffer(const std::vector<unsigned char>& buffer) {
   return getBuffer(buffer.data());
 }
 
-[[nodiscard]] inline uint32_t getSize() const {
+/// appends the message to a scatter-gather writer. large contiguous fields are referenced, not copied
+void appendSegments(SegmentWriter& writer) const;
+
+/// returns false if the reader runs out of bytes before the message is complete
+bool getBuffer(BufferReader& reader);
+
+/// serialized size. an upper bound if the message has @compress fields, exact otherwise
+[[nodiscard]] @@GET_SIZE_SPECIFIER@@ uint32_t getSize() const {
   uint32_t temp = 0;
   @@BUFFER_SIZE_EXPRESSION@@
   return temp;
 }
 
+/// serializes into a newly allocated buffer
+[[nodiscard]] inline std::vector<unsigned char> serialize() const {
+  std::vector<unsigned char> buffer(getSize());
+  buffer.resize(setBuffer(buffer.data()) - buffer.data());
+  return buffer;
+}
+
+/// serializes into a caller-owned buffer. returns the number of bytes written, or 0 if capacity is insufficient
+[[nodiscard]] inline size_t serializeInto(unsigned char* buffer, size_t capacity) const {
+  if (getSize() > capacity) return 0;
+  return setBuffer(buffer) - buffer;
+}
+
+/// bytes of the field mask in front of a delta
+static constexpr size_t kDeltaMaskSize = (@@VIEW_FIELD_COUNT@@ + 7) / 8;
+
+/// appends a field mask followed by only the fields that differ from previousMsg.
+/// a keyframe contains every field, so it can be applied without the previous state
+void setBufferDelta(std::vector<unsigned char>& buffer, const @@MESSAGE_NAME@@& previousMsg, bool isKeyframe = false) const;
+
+/// applies a delta of setBufferDelta on top of this, which must hold the previous message of the writer
+const unsigned char* applyDelta(const unsigned char* buffer);
+
+bool applyDelta(BufferReader& reader);
+
+static constexpr std::string_view kDataType = "@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@";
+/// hash of the recursive field layout, differs if the two sides were generated from different definitions
+static constexpr uint64_t kTypeHash = @@TYPE_HASH@@;
+
 inline static std::string getDataType() {
-  return "@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@";
+  return std::string(kDataType);
 }
 
 @@MEMBERS@@
+@@FIXED_SIZE_DECLARATION@@
+/// read-only view over a serialized @@MESSAGE_NAME@@ that decodes fields on access.
+/// field offsets are computed once on construction and the viewed buffer must outlive the view.
+class ConstView {
+ public:
+  ConstView() = default;
+
+  explicit ConstView(const unsigned char* buffer) : begin_(buffer) {
+    const unsigned char* temp = buffer;
+    @@VIEW_OFFSETS@@
+    end_ = temp;
+  }
+
+  explicit ConstView(const std::vector<unsigned char>& buffer) : ConstView(buffer.data()) {}
+
+  @@VIEW_ACCESSORS@@
+
+  [[nodiscard]] inline const unsigned char* getData() const { return begin_; }
+  [[nodiscard]] inline const unsigned char* getEnd() const { return end_; }
+  [[nodiscard]] inline uint32_t getSize() const { return static_cast<uint32_t>(end_ - begin_); }
+
+  inline void copyTo(@@MESSAGE_NAME@@& msg) const { msg.getBuffer(begin_); }
+
+ private:
+  const unsigned char* begin_ = nullptr;
+  const unsigned char* end_ = nullptr;
+  std::array<uint32_t, @@VIEW_FIELD_COUNT@@> offset_{};
+};
 
 using ConstSharedPtr = std::shared_ptr<const @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>;
 using SharedPtr = std::shared_ptr<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>;
 using ConstUniquePtr = std::unique_ptr<const @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>;
 using UniquePtr = std::unique_ptr<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>;
+using Pool = ::raisin::MessagePool<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>;
 };
+
+/// codec bodies. with message_codec_library they are compiled once into @@PROJECT_NAME@@_msgs instead of in every includer
+@@CODEC_IMPLEMENTATION_BEGIN@@
+@@CODEC_SPECIFIER@@ unsigned char* @@MESSAGE_NAME@@::setBuffer(unsigned char* buffer) const {
+  if constexpr (::raisin::is_packed_message<@@MESSAGE_NAME@@>::value) {
+    std::memcpy(buffer, this, sizeof(@@MESSAGE_NAME@@));
+    return buffer + sizeof(@@MESSAGE_NAME@@);
+  }
+  @@SET_BUFFER_MEMBERS2@@
+  return buffer;
+}
+
+@@CODEC_SPECIFIER@@ const unsigned char* @@MESSAGE_NAME@@::getBuffer(const unsigned char *buffer) {
+  if constexpr (::raisin::is_packed_message<@@MESSAGE_NAME@@>::value) {
+    std::memcpy(static_cast<void*>(this), buffer, sizeof(@@MESSAGE_NAME@@));
+    return buffer + sizeof(@@MESSAGE_NAME@@);
+  }
+  const unsigned char* temp = buffer;
+  @@GET_BUFFER_MEMBERS@@
+  return temp;
+}
+
+@@CODEC_SPECIFIER@@ void @@MESSAGE_NAME@@::appendSegments(SegmentWriter& writer) const {
+  if constexpr (::raisin::is_packed_message<@@MESSAGE_NAME@@>::value) {
+    writer.append(this, sizeof(@@MESSAGE_NAME@@));
+    return;
+  }
+  @@APPEND_SEGMENTS_MEMBERS@@
+}
+
+@@CODEC_SPECIFIER@@ bool @@MESSAGE_NAME@@::getBuffer(BufferReader& reader) {
+  if constexpr (::raisin::is_packed_message<@@MESSAGE_NAME@@>::value) {
+    return reader.read(static_cast<void*>(this), sizeof(@@MESSAGE_NAME@@));
+  }
+  @@GET_READER_MEMBERS@@
+  return reader.ok();
+}
+
+@@CODEC_SPECIFIER@@ void @@MESSAGE_NAME@@::setBufferDelta(std::vector<unsigned char>& buffer, [[maybe_unused]] const @@MESSAGE_NAME@@& previousMsg,
+                                              [[maybe_unused]] bool isKeyframe) const {
+  const size_t maskOffset = buffer.size();
+  std::array<unsigned char, kDeltaMaskSize> fieldMask{};
+  buffer.resize(maskOffset + kDeltaMaskSize);
+  @@SET_DELTA_MEMBERS@@
+  std::copy(fieldMask.begin(), fieldMask.end(), buffer.begin() + maskOffset);
+}
+
+@@CODEC_SPECIFIER@@ const unsigned char* @@MESSAGE_NAME@@::applyDelta(const unsigned char* buffer) {
+  std::array<unsigned char, kDeltaMaskSize> fieldMask{};
+  std::copy(buffer, buffer + kDeltaMaskSize, fieldMask.begin());
+  const unsigned char* temp = buffer + kDeltaMaskSize;
+  @@APPLY_DELTA_MEMBERS@@
+  return temp;
+}
+
+@@CODEC_SPECIFIER@@ bool @@MESSAGE_NAME@@::applyDelta(BufferReader& reader) {
+  std::array<unsigned char, kDeltaMaskSize> fieldMask{};
+  if (!reader.read(fieldMask.data(), kDeltaMaskSize)) return false;
+  @@APPLY_DELTA_READER_MEMBERS@@
+  return reader.ok();
+}
+@@CODEC_IMPLEMENTATION_END@@
 }
 
 static inline void setBuffer(std::vector<unsigned char>& buffer, const @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@& msg) {
@@ -83,22 +206,35 @@ static inline const unsigned char *getBuffer(const std::vector<unsigned char>& b
 return msg.getBuffer(buffer);
 }
 
-static inline void setBuffer(std::vector<unsigned char>& buffer, const std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
-  setBuffer(buffer, static_cast<uint32_t>(val.size()));
-  for (size_t i = 0; i<val.size(); i++) {
-    setBuffer(buffer, val[i]);
+static inline bool getBuffer(BufferReader& reader, @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@& msg) {
+  return msg.getBuffer(reader);
+}
+
+static inline void appendSegments(SegmentWriter& writer, const @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@& msg) {
+  msg.appendSegments(writer);
+}
+
+static inline void appendSegments(SegmentWriter& writer, const std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
+  const uint32_t size = val.size();
+  writer.append(&size, sizeof(uint32_t));
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    writer.reference(val.data(), val.size() * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@));
+    return;
   }
+  for (const auto& v : val) appendSegments(writer, v);
 }
 
 template<size_t n>
-static inline void setBuffer(std::vector<unsigned char>& buffer, const std::array<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@, n>& val) {
-  for (size_t i = 0; i<n; i++) {
-    setBuffer(buffer, val[i]);
-  }
+static inline void appendSegments(SegmentWriter& writer, const std::array<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@, n>& val) {
+  for (const auto& v : val) appendSegments(writer, v);
 }
 
 static inline unsigned char* setBuffer(unsigned char* buffer, const std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
   buffer = setBuffer(buffer, static_cast<uint32_t>(val.size()));
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    if (!val.empty()) std::memcpy(buffer, val.data(), val.size() * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@));
+    return buffer + val.size() * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@);
+  }
   for (size_t i = 0; i<val.size(); i++) {
     buffer = setBuffer(buffer, val[i]);
   }
@@ -114,10 +250,46 @@ static inline unsigned char* setBuffer(unsigned char* buffer, const std::array<@
   return buffer;
 }
 
+/// appends count messages of a contiguous array as one frame, encoded like a std::vector of them
+static inline void setBufferBatch(std::vector<unsigned char>& buffer, const @@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@* msgs, size_t count) {
+  size_t size = sizeof(uint32_t);
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    size += count * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@);
+  } else {
+    for (size_t i = 0; i < count; i++) size += msgs[i].getSize();
+  }
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + size);
+  unsigned char* out = setBuffer(buffer.data() + originalSize, static_cast<uint32_t>(count));
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    if (count > 0) std::memcpy(out, msgs, count * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@));
+    return;
+  }
+  for (size_t i = 0; i < count; i++) out = setBuffer(out, msgs[i]);
+  buffer.resize(out - buffer.data());
+}
+
+static inline void setBuffer(std::vector<unsigned char>& buffer, const std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
+  setBufferBatch(buffer, val.data(), val.size());
+}
+
+template<size_t n>
+static inline void setBuffer(std::vector<unsigned char>& buffer, const std::array<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@, n>& val) {
+  size_t size = 0;
+  for (const auto& v : val) size += v.getSize();
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + size);
+  buffer.resize(setBuffer(buffer.data() + originalSize, val) - buffer.data());
+}
+
 static inline const unsigned char *getBuffer(const unsigned char *buffer, std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
   uint32_t size;
   buffer = getBuffer(buffer, size);
   val.resize(size);
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    if (size > 0) std::memcpy(static_cast<void*>(val.data()), buffer, size * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@));
+    return buffer + size * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@);
+  }
   for (size_t i=0; i<size; i++)
     buffer = getBuffer(buffer, val[i]);
   return buffer;
@@ -130,6 +302,41 @@ static inline const unsigned char *getBuffer(const unsigned char *buffer, std::a
   return buffer;
 }
 
+static inline bool getBuffer(BufferReader& reader, std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& val) {
+  uint32_t size;
+  if (!getBuffer(reader, size)) return false;
+  if constexpr (is_packed_message<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>::value) {
+    if (size_t(size) * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@) > reader.getRemaining()) {
+      reader.fail();
+      return false;
+    }
+    val.resize(size);
+    return reader.read(static_cast<void*>(val.data()), size_t(size) * sizeof(@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@));
+  }
+  val.resize(std::min(size_t(size), reader.getRemaining()));
+  for (size_t i=0; i<size; i++) {
+    if (i == val.size()) val.emplace_back();
+    if (!getBuffer(reader, val[i])) return false;
+  }
+  return true;
+}
+
+template<size_t n>
+static inline bool getBuffer(BufferReader& reader, std::array<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@, n>& val) {
+  for (size_t i=0; i<n; i++)
+    if (!getBuffer(reader, val[i])) return false;
+  return true;
+}
+
+/// decodes a frame of setBufferBatch. msgs keeps its capacity
+static inline const unsigned char* getBufferBatch(const unsigned char* buffer, std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& msgs) {
+  return getBuffer(buffer, msgs);
+}
+
+static inline bool getBufferBatch(BufferReader& reader, std::vector<@@PROJECT_NAME@@::msg::@@MESSAGE_NAME@@>& msgs) {
+  return getBuffer(reader, msgs);
+}
+
 }
 
 
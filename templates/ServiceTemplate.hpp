@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <array>
 #include <cstdint>
 #include "../../raisin_serialization_base.hpp"
@@ -22,8 +23,11 @@ namespace @@PROJECT_NAME@@::srv {
 class @@SERVICE_NAME@@ {
 public:
 
+static constexpr std::string_view kDataType = "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@";
+static constexpr uint64_t kTypeHash = @@TYPE_HASH@@;
+
 inline static std::string getDataType() {
-  return "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@";
+  return std::string(kDataType);
 }
 
 class Request {
@@ -34,11 +38,13 @@ class Request {
     ;
   }
 
-  inline void setBuffer([[maybe_unused]] std::vector<unsigned char> &buffer) const {
-    @@REQUEST_SET_BUFFER_MEMBERS@@
-  };
+  inline void setBuffer(std::vector<unsigned char> &buffer) const {
+    const size_t originalSize = buffer.size();
+    buffer.resize(originalSize + getSize());
+    buffer.resize(setBuffer(buffer.data() + originalSize) - buffer.data());
+  }
 
-  inline unsigned char* setBuffer(unsigned char* buffer) const {
+  inline unsigned char* setBuffer([[maybe_unused]] unsigned char* buffer) const {
     @@REQUEST_SET_BUFFER_MEMBERS2@@
     return buffer;
   }
@@ -53,14 +59,33 @@ class Request {
     return getBuffer(buffer.data());
   }
 
+  inline bool getBuffer(BufferReader& reader) {
+    @@REQUEST_GET_READER_MEMBERS@@
+    return reader.ok();
+  }
+
   [[nodiscard]] inline uint32_t getSize() const {
     uint32_t temp = 0;
     @@REQUEST_BUFFER_SIZE@@
     return temp;
   }
 
+  [[nodiscard]] inline std::vector<unsigned char> serialize() const {
+    std::vector<unsigned char> buffer(getSize());
+    buffer.resize(setBuffer(buffer.data()) - buffer.data());
+    return buffer;
+  }
+
+  [[nodiscard]] inline size_t serializeInto(unsigned char* buffer, size_t capacity) const {
+    if (getSize() > capacity) return 0;
+    return setBuffer(buffer) - buffer;
+  }
+
+  static constexpr std::string_view kDataType = "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@::Request";
+  static constexpr uint64_t kTypeHash = @@REQUEST_TYPE_HASH@@;
+
   inline static std::string getDataType() {
-    return "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@::Request";
+    return std::string(kDataType);
   }
 
   @@REQUEST_MEMBERS@@
@@ -76,11 +101,13 @@ class Response {
     ;
   }
 
-  inline void setBuffer([[maybe_unused]] std::vector<unsigned char> &buffer) const {
-    @@RESPONSE_SET_BUFFER_MEMBERS@@
-  };
+  inline void setBuffer(std::vector<unsigned char> &buffer) const {
+    const size_t originalSize = buffer.size();
+    buffer.resize(originalSize + getSize());
+    buffer.resize(setBuffer(buffer.data() + originalSize) - buffer.data());
+  }
 
-  inline unsigned char* setBuffer(unsigned char* buffer) const {
+  inline unsigned char* setBuffer([[maybe_unused]] unsigned char* buffer) const {
     @@RESPONSE_SET_BUFFER_MEMBERS2@@
     return buffer;
   }
@@ -95,14 +122,33 @@ class Response {
     return getBuffer(buffer.data());
   }
 
+  inline bool getBuffer(BufferReader& reader) {
+    @@RESPONSE_GET_READER_MEMBERS@@
+    return reader.ok();
+  }
+
   [[nodiscard]] inline uint32_t getSize() const {
     uint32_t temp = 0;
     @@RESPONSE_BUFFER_SIZE@@
     return temp;
   }
 
+  [[nodiscard]] inline std::vector<unsigned char> serialize() const {
+    std::vector<unsigned char> buffer(getSize());
+    buffer.resize(setBuffer(buffer.data()) - buffer.data());
+    return buffer;
+  }
+
+  [[nodiscard]] inline size_t serializeInto(unsigned char* buffer, size_t capacity) const {
+    if (getSize() > capacity) return 0;
+    return setBuffer(buffer) - buffer;
+  }
+
+  static constexpr std::string_view kDataType = "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@::Response";
+  static constexpr uint64_t kTypeHash = @@RESPONSE_TYPE_HASH@@;
+
   inline static std::string getDataType() {
-    return "@@PROJECT_NAME@@::srv::@@SERVICE_NAME@@::Response";
+    return std::string(kDataType);
   }
 
   @@RESPONSE_MEMBERS@@
@@ -0,0 +1,234 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// micro-benchmarks of the generated codecs. every message is encoded into a reused buffer, decoded into a
+// reused message and sized with getSize(), and each case reports ns/op, GB/s and heap allocations per op.
+// usage: raisin_serialization_benchmark [--min-time seconds] [--filter substring] [--json path]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "raisin_benchmark_msgs/msg/scalars.hpp"
+#include "raisin_benchmark_msgs/msg/strings.hpp"
+#include "raisin_benchmark_msgs/msg/large_array.hpp"
+#include "raisin_benchmark_msgs/msg/nested_vector.hpp"
+#include "raisin_benchmark_msgs/msg/bools.hpp"
+#include "raisin_benchmark_msgs/msg/points.hpp"
+#include "raisin_benchmark_msgs/msg/point_columns.hpp"
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+
+void* countedAllocate(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace raisin {
+namespace benchmark {
+
+/// keeps the compiler from optimizing away the work that produced ptr
+static inline void escape(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(ptr) : "memory");
+#else
+  static const void* volatile sink;
+  sink = ptr;
+#endif
+}
+
+struct Result {
+  std::string name;
+  double nsPerOp = 0.;
+  double gbPerSecond = 0.;
+  double allocationsPerOp = 0.;
+};
+
+class Runner {
+ public:
+  Runner(double minSeconds, std::string filter) : minSeconds_(minSeconds), filter_(std::move(filter)) {}
+
+  /// runs fn until minSeconds elapsed. bytesPerOp is 0 for cases without a throughput
+  template<typename Fn>
+  void run(const std::string& name, size_t bytesPerOp, Fn&& fn) {
+    if (!filter_.empty() && name.find(filter_) == std::string::npos) return;
+    for (int i = 0; i < 16; i++) fn();
+
+    using Clock = std::chrono::steady_clock;
+    const uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+    uint64_t iterations = 0, batch = 1;
+    double seconds = 0.;
+    do {
+      for (uint64_t i = 0; i < batch; i++) fn();
+      iterations += batch;
+      batch = std::min<uint64_t>(batch * 2, 1u << 20);
+      seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < minSeconds_);
+    const uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    Result result;
+    result.name = name;
+    result.nsPerOp = seconds * 1e9 / double(iterations);
+    result.gbPerSecond = bytesPerOp == 0 ? 0. : double(bytesPerOp) / result.nsPerOp;
+    result.allocationsPerOp = double(allocations) / double(iterations);
+    std::printf("%-28s %12.1f ns/op %9.3f GB/s %8.2f allocs/op\n", name.c_str(), result.nsPerOp,
+                result.gbPerSecond, result.allocationsPerOp);
+    results_.push_back(result);
+  }
+
+  /// encode, decode and getSize of msg. the encoded size is the throughput of encode and decode
+  template<typename T>
+  void runMessage(const std::string& name, const T& msg) {
+    std::vector<unsigned char> buffer;
+    msg.setBuffer(buffer);
+    const size_t size = buffer.size();
+
+    run(name + "/encode", size, [&] {
+      buffer.clear();
+      msg.setBuffer(buffer);
+      escape(buffer.data());
+    });
+
+    T decoded;
+    run(name + "/decode", size, [&] {
+      decoded.getBuffer(buffer.data());
+      escape(&decoded);
+    });
+
+    run(name + "/getSize", 0, [&] {
+      uint32_t messageSize = msg.getSize();
+      escape(&messageSize);
+    });
+  }
+
+  [[nodiscard]] bool writeJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < results_.size(); i++) {
+      const auto& result = results_[i];
+      file << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << result.nsPerOp
+           << ", \"gb_per_s\": " << result.gbPerSecond << ", \"allocs_per_op\": " << result.allocationsPerOp
+           << "}" << (i + 1 < results_.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return bool(file);
+  }
+
+ private:
+  double minSeconds_;
+  std::string filter_;
+  std::vector<Result> results_;
+};
+
+static std::string randomString(std::mt19937& rng, size_t length) {
+  std::string val(length, ' ');
+  for (auto& c : val) c = static_cast<char>('a' + rng() % 26);
+  return val;
+}
+
+static void runAll(Runner& runner) {
+  std::mt19937 rng(42);
+
+  raisin_benchmark_msgs::msg::Scalars scalars;
+  scalars.id = 7;
+  scalars.value = 3.25;
+  scalars.valid = true;
+  scalars.stamp = 123456789;
+  scalars.offset = {0.1f, 0.2f, 0.3f};
+  runner.runMessage("Scalars", scalars);
+
+  raisin_benchmark_msgs::msg::Strings strings;
+  strings.name = randomString(rng, 48);
+  strings.frame_id = randomString(rng, 16);
+  for (int i = 0; i < 32; i++) strings.tags.push_back(randomString(rng, 8 + rng() % 24));
+  runner.runMessage("Strings", strings);
+
+  raisin_benchmark_msgs::msg::LargeArray largeArray;
+  largeArray.data.resize(256 * 1024);
+  for (auto& v : largeArray.data) v = float(rng() % 1000) * 0.001f;
+  largeArray.raw.resize(1024 * 1024);
+  for (auto& v : largeArray.raw) v = static_cast<uint8_t>(rng());
+  runner.runMessage("LargeArray", largeArray);
+
+  raisin_benchmark_msgs::msg::NestedVector nestedVector;
+  nestedVector.samples.resize(1000);
+  for (auto& sample : nestedVector.samples) {
+    sample.id = int32_t(rng() % 1000);
+    sample.x = double(rng() % 1000);
+    sample.y = double(rng() % 1000);
+    sample.label = randomString(rng, 12);
+  }
+  runner.runMessage("NestedVector", nestedVector);
+
+  raisin_benchmark_msgs::msg::Bools bools;
+  bools.flags.resize(64 * 1024);
+  for (size_t i = 0; i < bools.flags.size(); i++) bools.flags[i] = rng() % 2;
+  bools.packed = bools.flags;
+  runner.runMessage("Bools", bools);
+
+  raisin_benchmark_msgs::msg::Points points;
+  raisin_benchmark_msgs::msg::PointColumns pointColumns;
+  points.points.resize(100000);
+  for (auto& point : points.points) {
+    point.x = float(rng() % 1000);
+    point.y = float(rng() % 1000);
+    point.z = float(rng() % 1000);
+  }
+  pointColumns.points.assign(points.points);
+  runner.runMessage("Points", points);
+  runner.runMessage("PointColumns", pointColumns);
+}
+
+}  // namespace benchmark
+}  // namespace raisin
+
+int main(int argc, char** argv) {
+  double minSeconds = 0.2;
+  std::string filter, jsonPath;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--min-time" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (arg == "--json" && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else {
+      std::fprintf(stderr, "usage: %s [--min-time seconds] [--filter substring] [--json path]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  raisin::benchmark::Runner runner(minSeconds, filter);
+  raisin::benchmark::runAll(runner);
+
+  if (!jsonPath.empty() && !runner.writeJson(jsonPath)) {
+    std::fprintf(stderr, "could not write %s\n", jsonPath.c_str());
+    return 1;
+  }
+  return 0;
+}
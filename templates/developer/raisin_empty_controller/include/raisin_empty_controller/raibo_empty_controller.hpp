@@ -16,6 +16,10 @@
 #include "raisin_parameter/parameter_container.hpp"
 #include "raisin_controller/controller.hpp"
 #include "raisin_data_logger/raisin_data_logger.hpp"
+#include "raisin_interfaces/msg/command.hpp"
+#include "raisin_loop_monitor.hpp"
+#include "raisin_parameter_handle.hpp"
+#include "raisin_seqlock.hpp"
 
 namespace raisin
 {
@@ -41,6 +45,13 @@ public:
 
 private:
   parameter::ParameterContainer & param_;
+  // gains from params.yaml, read lock-free in advance()
+  ParameterHandle<double> jointPGain_;
+  ParameterHandle<double> jointDGain_;
+  uint64_t jointPGainVersion_ = 0;
+  uint64_t jointDGainVersion_ = 0;
+  // written by the command callback and read in advance() without blocking either thread
+  SeqLock<std::array<float, 3>> commandSnapshot_;
   Eigen::Vector3f command_;
 
   int n_joints_;
@@ -62,6 +73,8 @@ private:
   Eigen::VectorXd quat_;
 
   double loopTime_;
+  // execution time and jitter of advance() against comm_rate
+  LoopMonitor loopMonitor_;
 
   size_t logIdx_;
 };
@@ -3,6 +3,7 @@
 // 
  
 #include <filesystem>
+#include <limits>
 #include "raisin_util/raisin_directories.hpp"
 
 #include "raisin_empty_controller/raibo_empty_controller.hpp"
@@ -29,8 +30,17 @@ bool raiboEmptyController::create() {
 
   clk_ = 0;
   one_sec_clk_ = static_cast<int>(param_("comm_rate"));
+  loopMonitor_.setRate(static_cast<double>(one_sec_clk_));
   double joint_p_gain = param_("joint_p_gain");
   double joint_d_gain = param_("joint_d_gain");
+  // advance() reads the gains through handles, which reject a negative gain. another thread can set() them
+  // while the controller runs, and advance() picks up the new value without a parameter lookup per tick
+  jointPGain_.setRange(0., std::numeric_limits<double>::max());
+  jointDGain_.setRange(0., std::numeric_limits<double>::max());
+  if (!jointPGain_.set(joint_p_gain) || !jointDGain_.set(joint_d_gain)) {
+    RSWARN("joint_p_gain and joint_d_gain must not be negative")
+    return false;
+  }
 
   p_gain_.setZero(robotHub_->getDOF());
   d_gain_.setZero(robotHub_->getDOF());
@@ -71,6 +81,7 @@ bool raiboEmptyController::init() {
 
 bool raiboEmptyController::advance() {
   auto sectionTimer = SectionTimer(); // feature to measure elapsed time
+  loopMonitor_.begin();
 
   // you can get sensor measurements and estimated states
   auto imu = robotHub_->getSensorSet("base_imu")->getSensor<raisim::InertialMeasurementUnit>("imu");
@@ -80,15 +91,23 @@ bool raiboEmptyController::advance() {
   quat_ = imu->getOrientation().e();
   imu->unlockMutex();
 
-  robotHub_->lockMutex();
-  robotHub_->getState(gc_, gv_);
-  robotHub_->unlockMutex();
+  // a gain set since the last tick takes effect now
+  if (jointPGain_.changedSince(jointPGainVersion_)) p_gain_.tail(n_joints_).setConstant(jointPGain_.get());
+  if (jointDGain_.changedSince(jointDGainVersion_)) d_gain_.tail(n_joints_).setConstant(jointDGain_.get());
 
-  // set pd target for the robot
+  // latest command, without waiting for the callback thread
+  const auto command = commandSnapshot_.load();
+  command_ << command[0], command[1], command[2];
+
+  // read the state and set the pd target for the robot in one critical section,
+  // so the estimator and comm threads are contended once per tick. the imu and robot hub
+  // state stay behind their own mutexes, which are owned by raisin_controller
   robotHub_->lockMutex();
+  robotHub_->getState(gc_, gv_);
   robotHub_->setPdTarget(p_target_, d_target_);
   robotHub_->unlockMutex();
 
+  loopTime_ = static_cast<double>(loopMonitor_.end()) * 1e-9;
   dataLogger_.append(
           logIdx_, p_gain_, d_gain_, p_target_, d_target_, gc_, gv_, linAccB_, angVelB_, quat_, loopTime_);
 
@@ -109,7 +128,7 @@ bool raiboEmptyController::stop() {
 
 // you can receive command from external source(joy pad...)
 void raiboEmptyController::commandCallback(const raisin_interfaces::msg::Command::SharedPtr msg) {
-  command_ << msg->x_vel, msg->y_vel, msg->yaw_rate;
+  commandSnapshot_.store({float(msg->x_vel), float(msg->y_vel), float(msg->yaw_rate)});
 }
 
 extern "C" Controller * create(
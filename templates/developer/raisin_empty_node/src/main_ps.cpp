@@ -7,11 +7,27 @@
 
 #include "raisin_empty_node/raisin_empty_publisher_service.hpp"
 #include "raisin_network/raisin.hpp"
+#include "raisim/raisim_message.hpp"
+#include "raisin_rt.hpp"
 
 using namespace raisin;
 
 int main() {
   raisinInit();
+
+  // process-wide settings are applied once here, e.g. lockMemory = true when the process may use mlockall
+  for (const auto & warning : configureRealtimeProcess(RealtimeProcessConfig())) {
+    RSWARN("real-time settings denied, " << warning)
+  }
+
+  // the threads of the network inherit the affinity and scheduling of the thread that creates them.
+  // e.g. cpus = {2, 3}, policy = SchedulingPolicy::kFifo, priority = 80 for an isolated control group
+  RealtimeThreadGroups realtime_groups;
+  realtime_groups.set("ps", RealtimeThreadConfig());
+  for (const auto & warning : realtime_groups.apply("ps")) {
+    RSWARN("real-time settings denied, " << warning)
+  }
+
   std::vector<std::vector<std::string>> thread_spec = {{std::string("ps")}};
   auto network = std::make_shared<Network>("publisherAndService", "tutorial", thread_spec);
   network->launchServer(Remote::NetworkType::TCP);
@@ -8,7 +8,13 @@
 #ifndef RAISIN_EMPTY_PLUGIN_HPP_
 #define RAISIN_EMPTY_PLUGIN_HPP_
 
+#include <chrono>
+
 #include "raisin_plugin/plugin.hpp"
+#include "raisin_parameter/parameter_container.hpp"
+#include "raisin_loop_monitor_msgs/msg/loop_statistics.hpp"
+#include "raisin_loop_monitor.hpp"
+#include "raisin_rt.hpp"
 
 namespace raisin
 {
@@ -29,6 +35,17 @@ public:
   bool reset() final;
 
 private:
+  void publishLoopStatistics();
+
+  parameter::ParameterContainer & param_;
+  // thread settings from params.yaml, applied by the first advance() on the thread of this plugin's group
+  RealtimeThreadConfig realtimeConfig_;
+  bool realtimeApplied_ = false;
+  // timing of advance(), published on "loop_statistics" once per second
+  LoopMonitor loopMonitor_;
+  double loopRate_ = 0.;
+  std::chrono::steady_clock::time_point nextReport_{};
+  Publisher<raisin_loop_monitor_msgs::msg::LoopStatistics>::SharedPtr loopStatisticsPublisher_;
 };
 
 } // namespace plugin
@@ -16,9 +16,13 @@ namespace plugin
 EmptyPlugin::EmptyPlugin(
   raisim::World & world, raisim::RaisimServer & server,
   raisim::World & worldSim, raisim::RaisimServer & serverSim, GlobalResource & globalResource)
-: Node(globalResource.network), Plugin(world, server, worldSim, serverSim, globalResource)
+: Node(globalResource.network), Plugin(world, server, worldSim, serverSim, globalResource),
+  param_(parameter::ParameterContainer::getRoot()["empty_plugin"])
 {
+  param_.loadFromPackageParameterFile("raisin_empty_plugin");
   pluginType_ = PluginType::CUSTOM;
+  loopStatisticsPublisher_ =
+    createPublisher<raisin_loop_monitor_msgs::msg::LoopStatistics>("loop_statistics");
 }
 
 EmptyPlugin::~EmptyPlugin()
@@ -28,14 +32,59 @@ EmptyPlugin::~EmptyPlugin()
 
 bool EmptyPlugin::init()
 {
+  const std::string cpus = param_("cpus");
+  const std::string policy = param_("scheduling_policy");
+  const double priority = param_("priority");
+  const double prefault_stack_size = param_("prefault_stack_size");
+  if (!parseRealtimeThreadConfig(
+      cpus, policy, static_cast<int>(priority), static_cast<size_t>(prefault_stack_size), realtimeConfig_))
+  {
+    RSWARN("invalid real-time settings in params.yaml, the plugin thread is left unchanged")
+  }
+  loopRate_ = param_("rate");
+  loopMonitor_.setRate(loopRate_);
+  nextReport_ = std::chrono::steady_clock::now() + std::chrono::seconds(1);
   return true;
 }
 
 bool EmptyPlugin::advance()
 {
+  loopMonitor_.begin();
+  if (!realtimeApplied_) {
+    realtimeApplied_ = true;
+    for (const auto & warning : applyRealtimeThreadConfig(realtimeConfig_)) {
+      RSWARN("real-time settings denied, " << warning)
+    }
+  }
+
+  loopMonitor_.end();
+  publishLoopStatistics();
   return true;
 }
 
+void EmptyPlugin::publishLoopStatistics()
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (now < nextReport_) {return;}
+  nextReport_ = now + std::chrono::seconds(1);
+
+  const LoopStatistics statistics = loopMonitor_.getStatistics();
+  loopMonitor_.reset();
+  raisin_loop_monitor_msgs::msg::LoopStatistics msg;
+  msg.name = "empty_plugin";
+  msg.rate = loopRate_;
+  msg.iterations = statistics.iterations;
+  msg.overruns = statistics.overruns;
+  msg.execution_mean = statistics.executionMean;
+  msg.execution_p50 = statistics.executionP50;
+  msg.execution_p99 = statistics.executionP99;
+  msg.execution_p999 = statistics.executionP999;
+  msg.execution_max = statistics.executionMax;
+  msg.jitter_p99 = statistics.jitterP99;
+  msg.jitter_max = statistics.jitterMax;
+  loopStatisticsPublisher_->publish(msg);
+}
+
 bool EmptyPlugin::reset()
 {
   return true;
@@ -9,6 +9,7 @@
 #include "raisin_network/raisin.hpp"
 #include "std_msgs/msg/string.hpp"
 #include "raisin_network/raisin.hpp"
+#include "raisin_timed_loop.hpp"
 #include <iostream>
 
 using namespace raisin;
@@ -23,20 +24,30 @@ class PublisherNode : public raisin::Node
   {
     publisher_ = createPublisher<raisin::std_msgs::msg::String>("my_topic");
 
-    createTimedLoop("publish_loop", [this]() {
+    // scheduled against absolute deadlines on its own thread, so the rate does not drift with the publish time
+    const bool added = loops_.addLoop("publish_loop", [this]() {
       static int version = 0;
       raisin::std_msgs::msg::String msg;
       msg.data = "hello world " + std::to_string(version++);
       publisher_->publish(msg);
-    }, 10.);  // 1 Hz
+    }, 10., raisin::OverrunPolicy::kSkip);  // 10 Hz
+    if (!added) {
+      std::cout << "publish_loop: invalid rate" << std::endl;
+    }
+    loopThread_ = std::thread([this]() { loops_.run(); });
   }
 
   ~PublisherNode() {
+    // wakes the loop thread from its wait, so teardown does not wait out the rest of the period
+    loops_.stop();
+    loopThread_.join();
     cleanupResources();
   }
 
  private:
   raisin::Publisher<raisin::std_msgs::msg::String>::SharedPtr publisher_;
+  raisin::TimedLoopScheduler loops_;
+  std::thread loopThread_;
 };
 
 int main() {
@@ -20,6 +20,8 @@
 #include "raisin_data_logger/raisin_data_logger.hpp"
 #include "raisin_data_logger/raisin_timer.hpp"
 #include "raisin_network/node.hpp"
+#include "std_msgs/msg/string.hpp"
+#include "raisin_gui_snapshot.hpp"
 
 
 namespace raisin
@@ -38,6 +40,12 @@ public:
   bool reset() final;
 
 protected:
+  // latest message, handed over from the network thread without blocking its callback
+  TopicSnapshot<std_msgs::msg::String> stringSnapshot_;
+  Subscriber<std_msgs::msg::String>::SharedPtr stringSubscriber_;
+  // update() only runs while the window is shown, at most at this rate
+  UpdateThrottle updateThrottle_{30.};
+  bool visible_ = false;
 };
 
 }
@@ -13,10 +13,17 @@ namespace raisin
 emptyWindow::emptyWindow(const std::string & titleIn, std::shared_ptr<GuiResource> guiResource)
 : GuiWindow(titleIn, guiResource), Node(guiResource->network)
 {
+  stringSubscriber_ = createSubscriber<std_msgs::msg::String>("string_message", nullptr,
+    [this](const std::shared_ptr<std_msgs::msg::String> msg) {
+    stringSnapshot_.push(*msg);
+  });
 }
 
 bool emptyWindow::update()
 {
+  if (!updateThrottle_.isDue(open && visible_)) {return true;}
+
+  stringSnapshot_.update();
   return true;
 }
 
@@ -29,8 +36,10 @@ bool emptyWindow::draw()
 {
   if (!open) {return true;}
 
-  if (ImGui::Begin("empty window", &open)) {
+  visible_ = ImGui::Begin("empty window", &open);
+  if (visible_) {
     ImGui::Text("empty window");
+    ImGui::Text("string_message: %s", stringSnapshot_.getLatest().data.c_str());
   }
   ImGui::End();
   return open;
@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_GUI_LOOP_MONITOR_WINDOW_HPP_
+#define RAISIN_GUI_LOOP_MONITOR_WINDOW_HPP_
+
+#include <map>
+#include <string>
+
+#include "imgui/imgui.h"
+#include "raisin_gui_base/raisin_gui_window.hpp"
+
+// raisin include
+#include "raisin_network/node.hpp"
+#include "raisin_loop_monitor_msgs/msg/loop_statistics.hpp"
+#include "raisin_gui_snapshot.hpp"
+
+
+namespace raisin
+{
+
+/// table of the LoopStatistics published on "loop_statistics", one row per loop name
+class LoopMonitorWindow : public GuiWindow, public Node
+{
+public:
+  LoopMonitorWindow(const std::string & titleIn, std::shared_ptr<GuiResource> guiResource);
+  ~LoopMonitorWindow() { cleanupResources(); }
+
+  bool update() final;
+  bool init() final;
+  bool draw() final;
+  bool shutDown() final;
+  bool reset() final;
+
+protected:
+  using LoopStatisticsMsg = raisin_loop_monitor_msgs::msg::LoopStatistics;
+
+  // every report since the last update(), since several loops share the topic
+  TopicSnapshot<LoopStatisticsMsg> statisticsSnapshot_{64};
+  Subscriber<LoopStatisticsMsg>::SharedPtr statisticsSubscriber_;
+  std::map<std::string, LoopStatisticsMsg> loops_;
+  UpdateThrottle updateThrottle_{10.};
+  bool visible_ = false;
+};
+
+}
+#endif  // RAISIN_GUI_LOOP_MONITOR_WINDOW_HPP_
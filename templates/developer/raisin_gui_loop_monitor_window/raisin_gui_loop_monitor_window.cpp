@@ -0,0 +1,113 @@
+// Copyright (c) 2025 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#include "raisin_gui_loop_monitor_window/raisin_gui_loop_monitor_window.hpp"
+
+namespace raisin
+{
+
+LoopMonitorWindow::LoopMonitorWindow(
+  const std::string & titleIn,
+  std::shared_ptr<GuiResource> guiResource)
+: GuiWindow(titleIn, guiResource), Node(guiResource->network)
+{
+  statisticsSubscriber_ = createSubscriber<LoopStatisticsMsg>("loop_statistics", nullptr,
+    [this](const std::shared_ptr<LoopStatisticsMsg> msg) {
+    statisticsSnapshot_.push(*msg);
+  });
+}
+
+bool LoopMonitorWindow::update()
+{
+  if (!updateThrottle_.isDue(open && visible_)) {return true;}
+
+  statisticsSnapshot_.update();
+  for (size_t i = 0; i < statisticsSnapshot_.getHistorySize(); i++) {
+    const auto & statistics = statisticsSnapshot_.getHistory(i);
+    loops_[statistics.name] = statistics;
+  }
+  statisticsSnapshot_.clearHistory();
+  return true;
+}
+
+bool LoopMonitorWindow::init()
+{
+  return true;
+}
+
+bool LoopMonitorWindow::draw()
+{
+  if (!open) {return true;}
+
+  visible_ = ImGui::Begin("loop monitor", &open);
+  if (visible_) {
+    if (loops_.empty()) {
+      ImGui::Text("no loop statistics on \"loop_statistics\" yet");
+    } else if (ImGui::BeginTable("loops", 10, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      for (const char * header : {"loop", "rate [Hz]", "iterations", "overruns", "mean [us]", "p50 [us]",
+          "p99 [us]", "p99.9 [us]", "max [us]", "jitter p99/max [us]"})
+      {
+        ImGui::TableSetupColumn(header);
+      }
+      ImGui::TableHeadersRow();
+      const auto us = [](double ns) {return ns * 1e-3;};
+      for (const auto & [name, statistics] : loops_) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", name.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", statistics.rate);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(statistics.iterations));
+        ImGui::TableNextColumn();
+        // overruns are the number to watch, so they stand out
+        if (statistics.overruns > 0) {
+          ImGui::TextColored(ImVec4(1.f, 0.3f, 0.3f, 1.f), "%llu",
+            static_cast<unsigned long long>(statistics.overruns));
+        } else {
+          ImGui::Text("0");
+        }
+        for (double ns : {statistics.execution_mean, double(statistics.execution_p50),
+            double(statistics.execution_p99), double(statistics.execution_p999),
+            double(statistics.execution_max)})
+        {
+          ImGui::TableNextColumn();
+          ImGui::Text("%.1f", us(ns));
+        }
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f / %.1f", us(double(statistics.jitter_p99)), us(double(statistics.jitter_max)));
+      }
+      ImGui::EndTable();
+    }
+  }
+  ImGui::End();
+  return open;
+}
+
+bool LoopMonitorWindow::reset()
+{
+  loops_.clear();
+  return true;
+}
+
+bool LoopMonitorWindow::shutDown()
+{
+  return true;
+}
+
+
+extern "C" GuiWindow * create(const std::string & titleIn, std::shared_ptr<GuiResource> guiResource)
+{
+  return new LoopMonitorWindow(titleIn, guiResource);
+}
+
+extern "C" void destroy(GuiWindow * p)
+{
+  delete p;
+}
+
+}
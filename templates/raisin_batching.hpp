@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_BATCHING_HPP_
+#define RAISIN_WS_BATCHING_HPP_
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "raisin_serialization_base.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// batching
+
+/// a batch is flushed when any limit is reached. maxDelayMicroseconds counts from the oldest pending message
+struct BatchPolicy {
+  size_t maxMessages = 64;
+  size_t maxBytes = 64 * 1024;
+  int64_t maxDelayMicroseconds = 1000;
+};
+
+/// coalesces messages of one topic into a single frame, [uint32 count][messages], which is the
+/// encoding of std::vector<T> and of the generated setBufferBatch. pending messages are copied into
+/// slots that are reused, so their members keep their capacity between batches
+template<typename T>
+class MessageBatcher {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit MessageBatcher(BatchPolicy policy = {}) : policy_(policy) {}
+
+  /// queues a copy of msg. returns true if the batch is due
+  bool add(const T& msg, Clock::time_point now = Clock::now()) {
+    if (count_ == 0) oldest_ = now;
+    if (count_ == pending_.size()) pending_.emplace_back();
+    pending_[count_++] = msg;
+    bytes_ += msg.getSize();
+    return isDue(now);
+  }
+
+  [[nodiscard]] bool isDue(Clock::time_point now = Clock::now()) const {
+    return count_ > 0 && (count_ >= policy_.maxMessages || bytes_ >= policy_.maxBytes ||
+                          now - oldest_ >= std::chrono::microseconds(policy_.maxDelayMicroseconds));
+  }
+
+  /// the latest time the pending batch has to be flushed
+  [[nodiscard]] Clock::time_point getDeadline() const {
+    return oldest_ + std::chrono::microseconds(policy_.maxDelayMicroseconds);
+  }
+
+  [[nodiscard]] size_t getPendingCount() const { return count_; }
+
+  /// appends the pending messages as one frame and starts a new batch
+  void flush(std::vector<unsigned char>& buffer) {
+    buffer.reserve(buffer.size() + sizeof(uint32_t) + bytes_);
+    setBuffer(buffer, static_cast<uint32_t>(count_));
+    if constexpr (is_packed_message<T>::value) {
+      const size_t originalSize = buffer.size();
+      buffer.resize(originalSize + count_ * sizeof(T));
+      if (count_ > 0) std::memcpy(buffer.data() + originalSize, pending_.data(), count_ * sizeof(T));
+    } else {
+      for (size_t i = 0; i < count_; i++) pending_[i].setBuffer(buffer);
+    }
+    count_ = 0;
+    bytes_ = 0;
+  }
+
+ private:
+  BatchPolicy policy_;
+  std::vector<T> pending_;
+  size_t count_ = 0;
+  size_t bytes_ = 0;
+  Clock::time_point oldest_;
+};
+
+/// decodes a batch frame into msg one message at a time and calls callback(msg) for each,
+/// so a subscriber callback sees the same messages as without batching. returns false on truncation
+template<typename T, typename Callback>
+static inline bool forEachInBatch(BufferReader& reader, T& msg, Callback&& callback) {
+  uint32_t count;
+  if (!getBuffer(reader, count)) return false;
+  for (uint32_t i = 0; i < count; i++) {
+    if (!msg.getBuffer(reader)) return false;
+    callback(static_cast<const T&>(msg));
+  }
+  return true;
+}
+
+}
+
+#endif // RAISIN_WS_BATCHING_HPP_
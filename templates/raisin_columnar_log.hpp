@@ -0,0 +1,216 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_COLUMNAR_LOG_HPP_
+#define RAISIN_WS_COLUMNAR_LOG_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "raisin_spsc_ring.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// asynchronous columnar log
+
+/// a signal of the log, elementCount float64 values per row
+struct LogColumn {
+  std::string name;
+  uint32_t elementCount = 1;
+};
+
+/// writes rows of float64 columns to a file that can be memory-mapped and read one column at a time.
+/// the file is [char[8] "RSNCLOG1"][uint32 columnCount][uint32 headerSize] followed by
+/// [uint32 elementCount][uint16 nameLength][name] per column, zero-padded to headerSize (a multiple of 8).
+/// after it come blocks of [uint32 rowCount][uint32 0] and then, for each column, its rowCount * elementCount
+/// values. a reader locates a column from the block sizes alone, without touching the other columns
+class ColumnarLogWriter {
+ public:
+  static constexpr char kMagic[8] = {'R', 'S', 'N', 'C', 'L', 'O', 'G', '1'};
+
+  explicit ColumnarLogWriter(size_t blockRows = 1024) : blockRows_(std::max<size_t>(blockRows, 1)) {}
+  ColumnarLogWriter(const ColumnarLogWriter&) = delete;
+  ColumnarLogWriter& operator=(const ColumnarLogWriter&) = delete;
+  ~ColumnarLogWriter() { close(); }
+
+  bool open(const std::string& path, std::vector<LogColumn> columns) {
+    close();
+    columns_ = std::move(columns);
+    columnOffsets_.clear();
+    rowSize_ = 0;
+    std::vector<unsigned char> header(kMagic, kMagic + sizeof(kMagic));
+    header.resize(16);
+    const auto columnCount = static_cast<uint32_t>(columns_.size());
+    std::memcpy(header.data() + 8, &columnCount, sizeof(columnCount));
+    for (const auto& column : columns_) {
+      columnOffsets_.push_back(rowSize_);
+      rowSize_ += column.elementCount;
+      const auto nameLength = static_cast<uint16_t>(std::min<size_t>(column.name.size(), 0xFFFF));
+      const size_t offset = header.size();
+      header.resize(offset + sizeof(uint32_t) + sizeof(uint16_t) + nameLength);
+      std::memcpy(header.data() + offset, &column.elementCount, sizeof(uint32_t));
+      std::memcpy(header.data() + offset + sizeof(uint32_t), &nameLength, sizeof(uint16_t));
+      std::memcpy(header.data() + offset + sizeof(uint32_t) + sizeof(uint16_t), column.name.data(), nameLength);
+    }
+    header.resize((header.size() + 7) / 8 * 8);
+    const auto headerSize = static_cast<uint32_t>(header.size());
+    std::memcpy(header.data() + 12, &headerSize, sizeof(headerSize));
+
+    block_.assign(blockRows_ * rowSize_, 0.);
+    rows_ = 0;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    if (std::fwrite(header.data(), 1, header.size(), file_) != header.size()) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  [[nodiscard]] bool isOpen() const { return file_ != nullptr; }
+  [[nodiscard]] const std::vector<LogColumn>& getColumns() const { return columns_; }
+  /// float64 values per row, the sum of the element counts
+  [[nodiscard]] size_t getRowSize() const { return rowSize_; }
+
+  /// row holds getRowSize() values, the columns in order. a full block is written out
+  bool appendRow(const double* row) {
+    if (!file_) return false;
+    for (size_t c = 0; c < columns_.size(); c++) {
+      const size_t count = columns_[c].elementCount;
+      std::memcpy(block_.data() + blockRows_ * columnOffsets_[c] + rows_ * count, row + columnOffsets_[c],
+                  count * sizeof(double));
+    }
+    return ++rows_ < blockRows_ || flush();
+  }
+
+  /// writes the buffered rows as a block
+  bool flush() {
+    if (!file_ || rows_ == 0) return file_ != nullptr;
+    const uint32_t blockHeader[2] = {static_cast<uint32_t>(rows_), 0};
+    bool ok = std::fwrite(blockHeader, sizeof(blockHeader), 1, file_) == 1;
+    for (size_t c = 0; c < columns_.size() && ok; c++) {
+      const size_t count = rows_ * columns_[c].elementCount;
+      ok = std::fwrite(block_.data() + blockRows_ * columnOffsets_[c], sizeof(double), count, file_) == count;
+    }
+    rows_ = 0;
+    return ok;
+  }
+
+  bool close() {
+    if (!file_) return true;
+    const bool ok = flush();
+    const bool closed = std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok && closed;
+  }
+
+ private:
+  std::FILE* file_ = nullptr;
+  std::vector<LogColumn> columns_;
+  std::vector<size_t> columnOffsets_;
+  size_t rowSize_ = 0;
+  size_t blockRows_;
+  std::vector<double> block_;
+  size_t rows_ = 0;
+};
+
+namespace internal {
+
+/// copies a scalar or a contiguous container (Eigen vectors, std::array, std::vector) into count values.
+/// missing values are zero, extra ones are dropped
+template<typename V>
+static inline void copyLogValues(double* dst, size_t count, const V& val) {
+  if constexpr (std::is_arithmetic<V>::value) {
+    std::fill(dst, dst + count, 0.);
+    if (count > 0) dst[0] = static_cast<double>(val);
+  } else {
+    const size_t available = std::min(count, static_cast<size_t>(val.size()));
+    for (size_t i = 0; i < available; i++) dst[i] = static_cast<double>(val.data()[i]);
+    std::fill(dst + available, dst + count, 0.);
+  }
+}
+
+}  // namespace internal
+
+/// logger for a real-time loop. append() only copies a row into a preallocated SpscRing, and a background
+/// thread drains it into a ColumnarLogWriter, so file I/O never stalls the caller. a row that finds
+/// the ring full is dropped and counted. append() must be called from one thread at a time
+class AsyncColumnarLogger {
+ public:
+  explicit AsyncColumnarLogger(size_t ringRows = 8192, size_t blockRows = 1024)
+      : ringRows_(ringRows), writer_(blockRows) {}
+  AsyncColumnarLogger(const AsyncColumnarLogger&) = delete;
+  AsyncColumnarLogger& operator=(const AsyncColumnarLogger&) = delete;
+  ~AsyncColumnarLogger() { close(); }
+
+  bool open(const std::string& path, std::vector<LogColumn> columns) {
+    close();
+    if (!writer_.open(path, std::move(columns))) return false;
+    ring_ = std::make_unique<SpscRing<std::vector<double>>>(ringRows_, std::vector<double>(writer_.getRowSize()));
+    droppedRows_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] { drainLoop(); });
+    return true;
+  }
+
+  /// one value per column in the order of open(). false if the row was dropped
+  template<typename... Values>
+  bool append(const Values&... values) {
+    if (!ring_ || sizeof...(Values) != writer_.getColumns().size()) return false;
+    const bool pushed = ring_->tryProduce([&](std::vector<double>& row) {
+      const auto& columns = writer_.getColumns();
+      size_t column = 0, offset = 0;
+      ((internal::copyLogValues(row.data() + offset, columns[column].elementCount, values),
+        offset += columns[column++].elementCount),
+       ...);
+    });
+    if (!pushed) droppedRows_.fetch_add(1, std::memory_order_relaxed);
+    return pushed;
+  }
+
+  /// rows lost because the background thread fell behind by more than ringRows
+  [[nodiscard]] uint64_t getDroppedRows() const { return droppedRows_.load(std::memory_order_relaxed); }
+
+  /// writes the remaining rows and closes the file
+  bool close() {
+    if (!thread_.joinable()) return true;
+    running_.store(false, std::memory_order_release);
+    thread_.join();
+    ring_.reset();
+    return writer_.close();
+  }
+
+ private:
+  void drainLoop() {
+    const auto write = [this](std::vector<double>& row) { writer_.appendRow(row.data()); };
+    while (running_.load(std::memory_order_acquire)) {
+      if (!ring_->tryConsume(write)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    while (ring_->tryConsume(write)) {
+    }
+  }
+
+  size_t ringRows_;
+  ColumnarLogWriter writer_;
+  std::unique_ptr<SpscRing<std::vector<double>>> ring_;
+  std::atomic<uint64_t> droppedRows_{0};
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+};
+
+}
+
+#endif // RAISIN_WS_COLUMNAR_LOG_HPP_
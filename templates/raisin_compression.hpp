@@ -0,0 +1,282 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_COMPRESSION_HPP_
+#define RAISIN_WS_COMPRESSION_HPP_
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include "raisin_serialization_base.hpp"
+
+#ifdef RAISIN_WITH_LZ4
+#include <lz4.h>
+#endif
+#ifdef RAISIN_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace raisin {
+
+//////////////////////////////////////
+/// compressed fields
+
+enum class Compression : uint8_t { kNone = 0, kLz4 = 1, kZstd = 2 };
+
+/// a field annotated with @compress is serialized as
+/// [uint8 codec][uint32 plain size][uint32 stored size][stored bytes], where the plain bytes are its usual encoding.
+/// fields smaller than the threshold, data that does not shrink and codecs that are not compiled in
+/// (RAISIN_WITH_LZ4, RAISIN_WITH_ZSTD) are stored with Compression::kNone.
+/// generated messages only include this header if they have a compressed field
+static constexpr uint32_t kCompressedFieldHeaderSize = sizeof(uint8_t) + 2 * sizeof(uint32_t);
+
+template<typename T>
+struct CompressedField {
+  const T& val;
+  Compression codec;
+  uint32_t threshold;
+};
+
+template<typename T>
+struct CompressedFieldRef {
+  T& val;
+};
+
+/// ViewTraits key of a compressed field. its view is a decoded copy
+template<typename T>
+struct Compressed {};
+
+namespace internal {
+
+// per-thread buffers that keep their capacity. a stack, since a compressed field may contain compressed fields
+class ScratchBuffer {
+  struct Storage {
+    std::vector<unsigned char> bytes;
+    // not zero-filled when it grows, for codec output that is written before it is read
+    std::unique_ptr<unsigned char[]> raw;
+    size_t rawCapacity = 0;
+  };
+
+ public:
+  ScratchBuffer() : depth_(depth()++) {
+    if (stack().size() <= depth_) stack().resize(depth_ + 1);
+    stack()[depth_].bytes.clear();
+  }
+  ~ScratchBuffer() { depth()--; }
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+  std::vector<unsigned char>& get() { return stack()[depth_].bytes; }
+
+  /// at least size bytes of uninitialized storage, valid until the next call or the end of this scope
+  unsigned char* getUninitialized(size_t size) {
+    Storage& storage = stack()[depth_];
+    if (storage.rawCapacity < size) {
+      storage.rawCapacity = std::max(size, 2 * storage.rawCapacity);
+      storage.raw.reset(new unsigned char[storage.rawCapacity]);
+    }
+    return storage.raw.get();
+  }
+
+ private:
+  static size_t& depth() {
+    thread_local size_t depth = 0;
+    return depth;
+  }
+  static std::deque<Storage>& stack() {
+    thread_local std::deque<Storage> stack;
+    return stack;
+  }
+
+  size_t depth_;
+};
+
+/// returns the compressed size, or 0 if the codec is unavailable or the result does not fit into capacity
+static inline size_t compress([[maybe_unused]] Compression codec, [[maybe_unused]] const unsigned char* src,
+                              [[maybe_unused]] size_t size, [[maybe_unused]] unsigned char* dst,
+                              [[maybe_unused]] size_t capacity) {
+#ifdef RAISIN_WITH_LZ4
+  if (codec == Compression::kLz4) {
+    const int result = LZ4_compress_default(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+                                            static_cast<int>(size), static_cast<int>(capacity));
+    return result > 0 ? static_cast<size_t>(result) : 0;
+  }
+#endif
+#ifdef RAISIN_WITH_ZSTD
+  if (codec == Compression::kZstd) {
+    const size_t result = ZSTD_compress(dst, capacity, src, size, 1);
+    return ZSTD_isError(result) ? 0 : result;
+  }
+#endif
+  return 0;
+}
+
+/// returns false if the codec is unavailable or the data is corrupt
+static inline bool decompress([[maybe_unused]] Compression codec, [[maybe_unused]] const unsigned char* src,
+                              [[maybe_unused]] size_t size, [[maybe_unused]] unsigned char* dst,
+                              [[maybe_unused]] size_t plainSize) {
+#ifdef RAISIN_WITH_LZ4
+  if (codec == Compression::kLz4)
+    return LZ4_decompress_safe(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+                               static_cast<int>(size), static_cast<int>(plainSize)) == static_cast<int>(plainSize);
+#endif
+#ifdef RAISIN_WITH_ZSTD
+  if (codec == Compression::kZstd) return ZSTD_decompress(dst, plainSize, src, size) == plainSize;
+#endif
+  return false;
+}
+
+/// false if the codec is unavailable or size stored bytes cannot decompress to plainSize bytes,
+/// so a corrupt or crafted header does not make the decoder allocate plainSize bytes
+static inline bool isPlausiblePlainSize([[maybe_unused]] Compression codec,
+                                        [[maybe_unused]] const unsigned char* src, [[maybe_unused]] size_t size,
+                                        [[maybe_unused]] uint32_t plainSize) {
+#ifdef RAISIN_WITH_LZ4
+  // an lz4 block expands at most 255 times
+  if (codec == Compression::kLz4) return uint64_t(plainSize) <= uint64_t(size) * 255;
+#endif
+#ifdef RAISIN_WITH_ZSTD
+  // ZSTD_compress records the content size in the frame header
+  if (codec == Compression::kZstd) return ZSTD_getFrameContentSize(src, size) == plainSize;
+#endif
+  return false;
+}
+
+/// compresses the plain bytes at stored in place if the field qualifies. returns the codec and the stored size
+static inline Compression compressInPlace(Compression codec, uint32_t threshold, unsigned char* stored,
+                                          uint32_t plainSize, uint32_t& storedSize) {
+  storedSize = plainSize;
+  if (codec == Compression::kNone || plainSize < threshold || plainSize < 2) return Compression::kNone;
+  ScratchBuffer scratch;
+  unsigned char* compressed = scratch.getUninitialized(plainSize - 1);
+  const size_t size = compress(codec, stored, plainSize, compressed, plainSize - 1);
+  if (size == 0) return Compression::kNone;
+  std::memcpy(stored, compressed, size);
+  storedSize = static_cast<uint32_t>(size);
+  return codec;
+}
+
+}  // namespace internal
+
+/// needs kCompressedFieldHeaderSize bytes plus the plain size of the field
+template<typename T>
+static inline unsigned char* setBuffer(unsigned char* buffer, const CompressedField<T>& field) {
+  unsigned char* stored = buffer + kCompressedFieldHeaderSize;
+  const uint32_t plainSize = static_cast<uint32_t>(setBuffer(stored, field.val) - stored);
+  uint32_t storedSize;
+  const Compression codec = internal::compressInPlace(field.codec, field.threshold, stored, plainSize, storedSize);
+  buffer = setBuffer(buffer, static_cast<uint8_t>(codec));
+  buffer = setBuffer(buffer, plainSize);
+  buffer = setBuffer(buffer, storedSize);
+  return buffer + storedSize;
+}
+
+template<typename T>
+static inline void setBuffer(std::vector<unsigned char>& buffer, const CompressedField<T>& field) {
+  const size_t headerOffset = buffer.size();
+  buffer.resize(headerOffset + kCompressedFieldHeaderSize);
+  setBuffer(buffer, field.val);
+  const uint32_t plainSize = static_cast<uint32_t>(buffer.size() - headerOffset - kCompressedFieldHeaderSize);
+  uint32_t storedSize;
+  const Compression codec = internal::compressInPlace(
+      field.codec, field.threshold, buffer.data() + headerOffset + kCompressedFieldHeaderSize, plainSize, storedSize);
+  unsigned char* header = buffer.data() + headerOffset;
+  header = setBuffer(header, static_cast<uint8_t>(codec));
+  header = setBuffer(header, plainSize);
+  setBuffer(header, storedSize);
+  buffer.resize(headerOffset + kCompressedFieldHeaderSize + storedSize);
+}
+
+/// a field with an unavailable codec or corrupt data is left default-constructed
+template<typename T>
+static inline const unsigned char* getBuffer(const unsigned char* buffer, CompressedFieldRef<T> field) {
+  uint8_t codec;
+  uint32_t plainSize, storedSize;
+  buffer = getBuffer(buffer, codec);
+  buffer = getBuffer(buffer, plainSize);
+  buffer = getBuffer(buffer, storedSize);
+  if (static_cast<Compression>(codec) == Compression::kNone) {
+    getBuffer(buffer, field.val);
+  } else if (!internal::isPlausiblePlainSize(static_cast<Compression>(codec), buffer, storedSize, plainSize)) {
+    field.val = T{};
+  } else {
+    internal::ScratchBuffer scratch;
+    unsigned char* plain = scratch.getUninitialized(plainSize);
+    if (internal::decompress(static_cast<Compression>(codec), buffer, storedSize, plain, plainSize)) {
+      BufferReader reader(plain, plainSize);
+      if (!getBuffer(reader, field.val)) field.val = T{};
+    } else {
+      field.val = T{};
+    }
+  }
+  return buffer + storedSize;
+}
+
+template<typename T>
+static inline bool getBuffer(BufferReader& reader, CompressedFieldRef<T> field) {
+  uint8_t codec;
+  uint32_t plainSize, storedSize;
+  if (!getBuffer(reader, codec) || !getBuffer(reader, plainSize) || !getBuffer(reader, storedSize)) return false;
+  if (storedSize > reader.getRemaining()) {
+    reader.fail();
+    return false;
+  }
+  if (static_cast<Compression>(codec) == Compression::kNone) {
+    // decoded in place from the next storedSize bytes, which keeps the bulk copies of the field
+    const size_t hidden = reader.limit(storedSize);
+    const bool decoded = getBuffer(reader, field.val) && reader.getRemaining() == 0;
+    reader.unlimit(hidden);
+    if (!decoded) reader.fail();
+    return reader.ok();
+  }
+  // the codecs need the stored bytes in one piece, and the reader may span segments
+  internal::ScratchBuffer storedScratch;
+  unsigned char* stored = storedScratch.getUninitialized(storedSize);
+  reader.read(stored, storedSize);
+  if (!internal::isPlausiblePlainSize(static_cast<Compression>(codec), stored, storedSize, plainSize)) {
+    reader.fail();
+    return false;
+  }
+  internal::ScratchBuffer plainScratch;
+  unsigned char* plain = plainScratch.getUninitialized(plainSize);
+  if (!internal::decompress(static_cast<Compression>(codec), stored, storedSize, plain, plainSize)) {
+    reader.fail();
+    return false;
+  }
+  BufferReader plainReader(plain, plainSize);
+  if (!getBuffer(plainReader, field.val) || plainReader.getRemaining() != 0) reader.fail();
+  return reader.ok();
+}
+
+template<typename T>
+static inline void appendSegments(SegmentWriter& writer, const CompressedField<T>& field) {
+  internal::ScratchBuffer scratch;
+  auto& encoded = scratch.get();
+  setBuffer(encoded, field);
+  writer.append(encoded.data(), encoded.size());
+}
+
+template<typename T>
+struct ViewTraits<Compressed<T>> {
+  using type = T;
+  static inline type view(const unsigned char* buffer) {
+    T val{};
+    getBuffer(buffer, CompressedFieldRef<T>{val});
+    return val;
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    uint32_t storedSize;
+    std::memcpy(&storedSize, buffer + sizeof(uint8_t) + sizeof(uint32_t), sizeof(uint32_t));
+    return buffer + kCompressedFieldHeaderSize + storedSize;
+  }
+};
+
+}
+
+#endif // RAISIN_WS_COMPRESSION_HPP_
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_CONFLATION_HPP_
+#define RAISIN_WS_CONFLATION_HPP_
+
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace raisin {
+
+//////////////////////////////////////
+/// conflation
+
+/// keeps only the newest pending message per key (e.g. the goal id of action feedback), so a slow
+/// consumer never sees superseded messages and nothing is serialized for them. a key is sent at most
+/// once per minInterval. keys are compared with operator==, which suits the few goals of an action server
+template<typename Key, typename T>
+class ConflatingQueue {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit ConflatingQueue(std::chrono::microseconds minInterval = std::chrono::microseconds::zero())
+      : minInterval_(minInterval) {}
+
+  /// stores msg as the pending message of key. returns true if it superseded one
+  bool push(const Key& key, const T& msg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+      if (entry.key == key) {
+        const bool superseded = entry.pending;
+        entry.msg = msg;
+        entry.pending = true;
+        dropped_ += superseded;
+        return superseded;
+      }
+    }
+    entries_.push_back({key, msg, true, Clock::time_point::min()});
+    return false;
+  }
+
+  /// calls callback(key, msg) for each pending message that may be sent now and returns how many.
+  /// the callback runs under the queue lock and should only serialize or copy the message
+  template<typename Callback>
+  size_t drain(Callback&& callback, Clock::time_point now = Clock::now()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto& entry : entries_) {
+      if (!entry.pending || (entry.lastSent != Clock::time_point::min() && now - entry.lastSent < minInterval_))
+        continue;
+      callback(static_cast<const Key&>(entry.key), static_cast<const T&>(entry.msg));
+      entry.pending = false;
+      entry.lastSent = now;
+      count++;
+    }
+    return count;
+  }
+
+  /// forgets a key, e.g. once its goal has finished
+  void erase(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < entries_.size(); i++) {
+      if (entries_[i].key == key) {
+        entries_[i] = std::move(entries_.back());
+        entries_.pop_back();
+        return;
+      }
+    }
+  }
+
+  [[nodiscard]] size_t getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& entry : entries_) count += entry.pending;
+    return count;
+  }
+
+  /// number of messages replaced before they were sent
+  [[nodiscard]] uint64_t getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    T msg;
+    bool pending;
+    Clock::time_point lastSent;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<Entry> entries_;
+  std::chrono::microseconds minInterval_;
+  uint64_t dropped_ = 0;
+};
+
+}
+
+#endif // RAISIN_WS_CONFLATION_HPP_
@@ -0,0 +1,254 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_DATAGRAM_HPP_
+#define RAISIN_WS_DATAGRAM_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "raisin_serialization_base.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// datagram fragmentation
+
+/// header in front of each datagram of a message sent over UDP (e.g. a multicast group per topic).
+/// a message is serialized once and split into fragments of at most one datagram, fragmentOffset is
+/// the position of the fragment in the message and messageSize the size of the whole message
+struct DatagramHeader {
+  static constexpr size_t kHeaderSize = 4 * sizeof(uint32_t) + 2 * sizeof(uint16_t);
+
+  uint32_t topicId = 0;
+  uint32_t sequence = 0;
+  uint32_t messageSize = 0;
+  uint32_t fragmentOffset = 0;
+  uint16_t fragmentIndex = 0;
+  uint16_t fragmentCount = 0;
+};
+
+static inline unsigned char* setBuffer(unsigned char* buffer, const DatagramHeader& val) {
+  buffer = setBuffer(buffer, val.topicId);
+  buffer = setBuffer(buffer, val.sequence);
+  buffer = setBuffer(buffer, val.messageSize);
+  buffer = setBuffer(buffer, val.fragmentOffset);
+  buffer = setBuffer(buffer, val.fragmentIndex);
+  return setBuffer(buffer, val.fragmentCount);
+}
+
+static inline const unsigned char* getBuffer(const unsigned char* buffer, DatagramHeader& val) {
+  buffer = getBuffer(buffer, val.topicId);
+  buffer = getBuffer(buffer, val.sequence);
+  buffer = getBuffer(buffer, val.messageSize);
+  buffer = getBuffer(buffer, val.fragmentOffset);
+  buffer = getBuffer(buffer, val.fragmentIndex);
+  return getBuffer(buffer, val.fragmentCount);
+}
+
+/// splits serialized messages of one topic into datagrams of at most maxDatagramSize bytes.
+/// the default fits an ethernet MTU of 1500 after the IPv4 and UDP headers.
+/// the datagram buffer is reused, so sending a message does not allocate
+class DatagramFragmenter {
+ public:
+  static constexpr size_t kDefaultDatagramSize = 1472;
+  /// fragmentIndex and fragmentCount are 16 bit
+  static constexpr size_t kMaxFragmentCount = 0xFFFF;
+
+  explicit DatagramFragmenter(uint32_t topicId, size_t maxDatagramSize = kDefaultDatagramSize)
+      : topicId_(topicId), datagram_(std::max(maxDatagramSize, DatagramHeader::kHeaderSize + 1)) {}
+
+  [[nodiscard]] size_t getMaxFragmentPayload() const { return datagram_.size() - DatagramHeader::kHeaderSize; }
+
+  /// largest message that fits in kMaxFragmentCount datagrams
+  [[nodiscard]] size_t getMaxMessageSize() const { return getMaxFragmentPayload() * kMaxFragmentCount; }
+
+  /// calls send(const unsigned char* datagram, size_t size) once per fragment, in order.
+  /// returns false without sending anything if the message exceeds getMaxMessageSize()
+  template<typename Send>
+  bool fragment(const unsigned char* message, size_t size, Send&& send) {
+    if (size > getMaxMessageSize() || uint64_t(size) > 0xFFFFFFFFu) return false;
+    const size_t payload = getMaxFragmentPayload();
+    DatagramHeader header;
+    header.topicId = topicId_;
+    header.sequence = sequence_++;
+    header.messageSize = static_cast<uint32_t>(size);
+    header.fragmentCount = static_cast<uint16_t>(size == 0 ? 1 : (size + payload - 1) / payload);
+    for (size_t offset = 0; header.fragmentIndex < header.fragmentCount; header.fragmentIndex++, offset += payload) {
+      const size_t chunk = std::min(payload, size - offset);
+      header.fragmentOffset = static_cast<uint32_t>(offset);
+      unsigned char* body = setBuffer(datagram_.data(), header);
+      if (chunk > 0) std::memcpy(body, message + offset, chunk);
+      send(static_cast<const unsigned char*>(datagram_.data()), DatagramHeader::kHeaderSize + chunk);
+    }
+    return true;
+  }
+
+  bool fragment(const std::vector<unsigned char>& message, std::function<void(const unsigned char*, size_t)> send) {
+    return fragment(message.data(), message.size(), send);
+  }
+
+  [[nodiscard]] uint32_t getSequence() const { return sequence_; }
+
+ private:
+  uint32_t topicId_;
+  uint32_t sequence_ = 0;
+  std::vector<unsigned char> datagram_;
+};
+
+/// reassembles the datagrams of one DatagramFragmenter and keeps loss statistics.
+/// fragments of up to maxPendingMessages messages may interleave or arrive out of order. a message
+/// older than the newest delivered one is dropped, and sequence numbers that were never completed
+/// count as lost. a sequence far behind the newest one, or a run of late datagrams, is taken as a
+/// restarted publisher and resynchronizes
+class DatagramReassembler {
+ public:
+  /// sequences further behind than this resynchronize instead of being dropped as late
+  static constexpr uint32_t kResyncWindow = 1024;
+  /// consecutive late datagrams after which the reassembler resynchronizes
+  static constexpr uint32_t kMaxLateRun = 16;
+
+  explicit DatagramReassembler(size_t maxMessageSize = 64u << 20, size_t maxPendingMessages = 4)
+      : maxMessageSize_(maxMessageSize), pending_(std::max<size_t>(maxPendingMessages, 1)) {}
+
+  /// calls deliver(const DatagramHeader& header, const unsigned char* message, size_t size) when the datagram
+  /// completes a message. the message memory is only valid during the call. returns false for a malformed datagram
+  template<typename Deliver>
+  bool receive(const unsigned char* datagram, size_t size, Deliver&& deliver) {
+    if (size < DatagramHeader::kHeaderSize) return false;
+    DatagramHeader header;
+    const unsigned char* body = getBuffer(datagram, header);
+    const size_t chunk = size - DatagramHeader::kHeaderSize;
+    if (header.fragmentCount == 0 || header.fragmentIndex >= header.fragmentCount ||
+        header.messageSize > maxMessageSize_ || size_t(header.fragmentOffset) + chunk > header.messageSize)
+      return false;
+
+    if (isLate(header.sequence)) {
+      if (++lateRun_ <= kMaxLateRun) {
+        lateCount_++;
+        return true;
+      }
+      synced_ = false;
+    }
+    lateRun_ = 0;
+
+    if (header.fragmentCount == 1) {
+      if (chunk != header.messageSize || header.fragmentOffset != 0) return false;
+      complete(header.sequence);
+      deliver(static_cast<const DatagramHeader&>(header), body, chunk);
+      return true;
+    }
+
+    const size_t payload = getFragmentPayload(header, chunk);
+    if (payload == 0) return false;
+    Pending& slot = findSlot(header);
+    if (slot.received.size() != header.fragmentCount || slot.message.size() != header.messageSize) return false;
+    // all fragments of a message must agree on the payload size, so none of them overlap
+    if (slot.payload == 0) slot.payload = payload;
+    if (slot.payload != payload) return false;
+    if (slot.received[header.fragmentIndex]) return true;
+    slot.received[header.fragmentIndex] = 1;
+    slot.receivedCount++;
+    if (chunk > 0) std::memcpy(slot.message.data() + header.fragmentOffset, body, chunk);
+
+    if (slot.receivedCount == header.fragmentCount) {
+      slot.active = false;
+      complete(header.sequence);
+      deliver(static_cast<const DatagramHeader&>(header), static_cast<const unsigned char*>(slot.message.data()),
+              size_t(header.messageSize));
+    }
+    return true;
+  }
+
+  bool receive(const std::vector<unsigned char>& datagram,
+               std::function<void(const DatagramHeader&, const unsigned char*, size_t)> deliver) {
+    return receive(datagram.data(), datagram.size(), deliver);
+  }
+
+  /// delivered messages
+  [[nodiscard]] uint64_t getReceivedCount() const { return receivedCount_; }
+  /// sequence numbers skipped between delivered messages
+  [[nodiscard]] uint64_t getLostCount() const { return lostCount_; }
+  /// datagrams of messages older than the newest delivered one
+  [[nodiscard]] uint64_t getLateCount() const { return lateCount_; }
+
+  /// fraction of messages lost since construction or the last resetStatistics()
+  [[nodiscard]] double getLossRatio() const {
+    const uint64_t total = receivedCount_ + lostCount_;
+    return total == 0 ? 0. : double(lostCount_) / double(total);
+  }
+
+  void resetStatistics() { receivedCount_ = lostCount_ = lateCount_ = 0; }
+
+ private:
+  struct Pending {
+    bool active = false;
+    uint32_t sequence = 0;
+    uint16_t receivedCount = 0;
+    size_t payload = 0;
+    std::vector<unsigned char> received;
+    std::vector<unsigned char> message;
+  };
+
+  /// the payload of every fragment but the last, as implied by a fragment of a message with more than one.
+  /// 0 if the fragment is not at index * payload or the fragments would not split messageSize into fragmentCount
+  static size_t getFragmentPayload(const DatagramHeader& header, size_t chunk) {
+    const size_t last = header.fragmentCount - 1u;
+    size_t payload = chunk;
+    if (header.fragmentIndex == last) {
+      if (header.fragmentOffset % last != 0 || size_t(header.fragmentOffset) + chunk != header.messageSize) return 0;
+      payload = header.fragmentOffset / last;
+    }
+    if (payload == 0 || size_t(header.fragmentOffset) != header.fragmentIndex * payload) return 0;
+    if (last * payload >= header.messageSize || header.messageSize > (last + 1) * payload) return 0;
+    return payload;
+  }
+
+  [[nodiscard]] bool isLate(uint32_t sequence) const {
+    if (!synced_) return false;
+    const int32_t diff = static_cast<int32_t>(sequence - nextSequence_);
+    return diff < 0 && diff >= -static_cast<int32_t>(kResyncWindow);
+  }
+
+  void complete(uint32_t sequence) {
+    const int32_t diff = static_cast<int32_t>(sequence - nextSequence_);
+    if (synced_ && diff > 0) lostCount_ += uint32_t(diff);
+    synced_ = true;
+    nextSequence_ = sequence + 1;
+    receivedCount_++;
+  }
+
+  /// the slot collecting header.sequence. a new message takes a free slot or evicts the oldest one
+  Pending& findSlot(const DatagramHeader& header) {
+    Pending* oldest = nullptr;
+    for (auto& slot : pending_) {
+      if (slot.active && slot.sequence == header.sequence) return slot;
+      if (!oldest || (oldest->active &&
+                      (!slot.active || static_cast<int32_t>(slot.sequence - oldest->sequence) < 0)))
+        oldest = &slot;
+    }
+    oldest->active = true;
+    oldest->sequence = header.sequence;
+    oldest->receivedCount = 0;
+    oldest->payload = 0;
+    oldest->received.assign(header.fragmentCount, 0);
+    oldest->message.resize(header.messageSize);
+    return *oldest;
+  }
+
+  size_t maxMessageSize_;
+  std::vector<Pending> pending_;
+  bool synced_ = false;
+  uint32_t nextSequence_ = 0;
+  uint32_t lateRun_ = 0;
+  uint64_t receivedCount_ = 0, lostCount_ = 0, lateCount_ = 0;
+};
+
+}
+
+#endif // RAISIN_WS_DATAGRAM_HPP_
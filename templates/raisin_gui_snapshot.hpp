@@ -0,0 +1,154 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_GUI_SNAPSHOT_HPP_
+#define RAISIN_WS_GUI_SNAPSHOT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "raisin_spsc_ring.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// gui snapshots
+
+/// hands the newest value from one writer thread to one reader thread without locks or copies on either
+/// side. the writer fills getWriteBuffer() and publishes it, the reader calls update() and then reads get().
+/// the three slots are copies of prototype, so they keep their capacity when they change hands
+template<typename T>
+class TripleBuffer {
+  static constexpr uint8_t kIndexMask = 3;
+  static constexpr uint8_t kFresh = 4;
+
+ public:
+  explicit TripleBuffer(const T& prototype = T()) : slots_{prototype, prototype, prototype} {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /// writer side. the buffer is not seen by the reader until publish()
+  T& getWriteBuffer() { return slots_[writeIndex_]; }
+
+  void publish() {
+    writeIndex_ = middle_.exchange(uint8_t(writeIndex_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  void write(const T& val) {
+    getWriteBuffer() = val;
+    publish();
+  }
+
+  /// reader side. takes the newest published value, false if nothing was published since the last update
+  bool update() {
+    if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+    readIndex_ = middle_.exchange(readIndex_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  [[nodiscard]] const T& get() const { return slots_[readIndex_]; }
+
+ private:
+  T slots_[3];
+  uint8_t writeIndex_ = 0;
+  alignas(64) std::atomic<uint8_t> middle_{1};
+  alignas(64) uint8_t readIndex_ = 2;
+};
+
+/// latest value of a topic for a gui window, plus an optional bounded history for plots. push() is called by
+/// the subscriber callback (one at a time) and never waits for the render thread, update() is called once per
+/// frame by the window. values that arrive while the history hand-off is full are dropped from the history
+/// only, the latest value is always kept
+template<typename T>
+class TopicSnapshot {
+ public:
+  explicit TopicSnapshot(size_t historyCapacity = 0, const T& prototype = T())
+      : latest_(prototype), pending_(historyCapacity == 0 ? 1 : historyCapacity, prototype),
+        history_(historyCapacity, prototype) {}
+
+  void push(const T& val) {
+    latest_.write(val);
+    if (history_.empty()) return;
+    if (!pending_.tryPush(val)) dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// moves the values pushed since the last call into the history. true if a new value arrived
+  bool update() {
+    const bool updated = latest_.update();
+    if (!history_.empty()) {
+      while (pending_.tryConsume([&](T& slot) {
+        std::swap(history_[(historyBegin_ + historySize_) % history_.size()], slot);
+        if (historySize_ < history_.size())
+          historySize_++;
+        else
+          historyBegin_ = (historyBegin_ + 1) % history_.size();
+      })) {}
+    }
+    return updated;
+  }
+
+  /// the values as of the last update(). a default-constructed T before the first value arrived
+  [[nodiscard]] const T& getLatest() const { return latest_.get(); }
+
+  [[nodiscard]] size_t getHistorySize() const { return historySize_; }
+  [[nodiscard]] size_t getHistoryCapacity() const { return history_.size(); }
+
+  /// i = 0 is the oldest value in the history
+  [[nodiscard]] const T& getHistory(size_t i) const { return history_[(historyBegin_ + i) % history_.size()]; }
+
+  void clearHistory() { historyBegin_ = historySize_ = 0; }
+
+  [[nodiscard]] uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  TripleBuffer<T> latest_;
+  SpscRing<T> pending_;
+  std::vector<T> history_;
+  size_t historyBegin_ = 0;
+  size_t historySize_ = 0;
+  std::atomic<uint64_t> dropped_{0};
+};
+
+/// limits how often a gui window does its update work. a hidden or collapsed window is never due, and a window
+/// that becomes visible again is due right away. rate is in Hz, 0 is every frame
+class UpdateThrottle {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit UpdateThrottle(double rate = 0.) { setRate(rate); }
+
+  void setRate(double rate) {
+    period_ = rate > 0. ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / rate))
+                        : Clock::duration::zero();
+  }
+
+  bool isDue(bool visible, Clock::time_point now = Clock::now()) {
+    if (!visible) {
+      hidden_ = true;
+      return false;
+    }
+    if (!hidden_ && now < next_) return false;
+    hidden_ = false;
+    // the next update is one period after this one, or after the missed deadline if the frame came late
+    next_ = (next_ + period_ > now) ? next_ + period_ : now + period_;
+    return true;
+  }
+
+ private:
+  Clock::duration period_ = Clock::duration::zero();
+  Clock::time_point next_{};
+  bool hidden_ = true;
+};
+
+}
+
+#endif // RAISIN_WS_GUI_SNAPSHOT_HPP_
@@ -0,0 +1,209 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_LOOP_MONITOR_HPP_
+#define RAISIN_WS_LOOP_MONITOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace raisin {
+
+//////////////////////////////////////
+/// loop instrumentation
+
+/// timestamps for hot loops. on x86 this reads the time-stamp counter, which is invariant on current CPUs
+/// and costs a few nanoseconds, elsewhere it is steady_clock in nanoseconds. the cycle rate is calibrated
+/// against steady_clock once per process, which takes about 10 ms on first use
+struct CycleClock {
+  static inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+
+  static inline double getNanosecondsPerCycle() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    static const double nanosecondsPerCycle = [] {
+      const auto start = std::chrono::steady_clock::now();
+      const uint64_t startCycles = now();
+      auto end = start;
+      while (end - start < std::chrono::milliseconds(10)) end = std::chrono::steady_clock::now();
+      const uint64_t cycles = now() - startCycles;
+      return std::chrono::duration<double, std::nano>(end - start).count() / double(std::max<uint64_t>(cycles, 1));
+    }();
+    return nanosecondsPerCycle;
+#else
+    return 1.;
+#endif
+  }
+
+  static inline uint64_t toNanoseconds(uint64_t cycles) {
+    return static_cast<uint64_t>(double(cycles) * getNanosecondsPerCycle());
+  }
+};
+
+/// histogram of nanosecond latencies with HDR-style log-linear buckets: values below 64 are exact and
+/// larger ones are kept with 32 buckets per power of two, i.e. within about 3 percent, up to about 18 minutes.
+/// recording is a few instructions and never allocates. not thread-safe, one writer per histogram
+class LatencyHistogram {
+  static constexpr uint32_t kSubBucketBits = 5;
+  static constexpr uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+  static constexpr uint32_t kMaxValueBits = 40;
+
+ public:
+  static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+  static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  /// values above kMaxValue are clamped
+  void record(uint64_t value) {
+    value = std::min(value, kMaxValue);
+    counts_[getBucketIndex(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; i++) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  void reset() { *this = LatencyHistogram(); }
+
+  [[nodiscard]] uint64_t getCount() const { return count_; }
+  [[nodiscard]] uint64_t getMin() const { return count_ == 0 ? 0 : min_; }
+  [[nodiscard]] uint64_t getMax() const { return max_; }
+  [[nodiscard]] double getMean() const { return count_ == 0 ? 0. : double(sum_) / double(count_); }
+
+  /// highest value of the bucket holding the given percentile (0 to 100), capped at the recorded maximum
+  [[nodiscard]] uint64_t getValueAtPercentile(double percentile) const {
+    if (count_ == 0) return 0;
+    const auto rank = static_cast<uint64_t>(std::clamp(percentile, 0., 100.) / 100. * double(count_));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      seen += counts_[i];
+      if (seen > rank || seen == count_) return std::min(getBucketUpperBound(i), max_);
+    }
+    return max_;
+  }
+
+  static inline size_t getBucketIndex(uint64_t value) {
+    if (value < 2 * kSubBucketCount) return static_cast<size_t>(value);
+#if defined(__GNUC__) || defined(__clang__)
+    const uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    uint32_t msb = 0;
+    while (value >> (msb + 1)) msb++;
+#endif
+    const uint32_t shift = msb - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * kSubBucketCount + ((value >> shift) - kSubBucketCount));
+  }
+
+  static inline uint64_t getBucketUpperBound(size_t index) {
+    if (index < 2 * kSubBucketCount) return index;
+    const uint64_t shift = index / kSubBucketCount - 1;
+    return (((index % kSubBucketCount) + kSubBucketCount + 1) << shift) - 1;
+  }
+
+ private:
+  std::array<uint64_t, kBucketCount> counts_{};
+  uint64_t count_ = 0, sum_ = 0;
+  uint64_t min_ = ~uint64_t(0), max_ = 0;
+};
+
+/// summary of a LoopMonitor in nanoseconds, e.g. to fill a raisin_loop_monitor_msgs/LoopStatistics message once per second
+struct LoopStatistics {
+  uint64_t iterations = 0;
+  /// iterations whose execution took longer than the period of the configured rate
+  uint64_t overruns = 0;
+  double executionMean = 0.;
+  uint64_t executionP50 = 0, executionP99 = 0, executionP999 = 0, executionMax = 0;
+  /// deviation of the start-to-start period from the configured one
+  uint64_t jitterP99 = 0, jitterMax = 0;
+};
+
+/// instruments one periodic loop, e.g. Controller::advance(), Plugin::advance() or a createTimedLoop callback.
+/// call begin() when an iteration starts and end() when it is done. rate is the configured frequency in Hz,
+/// 0 for a loop without a deadline. only the loop thread may call the methods
+class LoopMonitor {
+ public:
+  explicit LoopMonitor(double rate = 0.) { setRate(rate); }
+
+  void setRate(double rate) {
+    periodNs_ = rate > 0. ? static_cast<uint64_t>(1e9 / rate) : 0;
+    periodCycles_ = rate > 0. ? static_cast<uint64_t>(1e9 / rate / CycleClock::getNanosecondsPerCycle()) : 0;
+  }
+
+  void begin() {
+    const uint64_t now = CycleClock::now();
+    if (periodNs_ != 0 && lastBegin_ != 0) {
+      const uint64_t period = now - lastBegin_;
+      jitter_.record(CycleClock::toNanoseconds(period > periodCycles_ ? period - periodCycles_
+                                                                      : periodCycles_ - period));
+    }
+    lastBegin_ = now;
+  }
+
+  /// returns the execution time of the iteration in nanoseconds
+  uint64_t end() {
+    const uint64_t executionNs = CycleClock::toNanoseconds(CycleClock::now() - lastBegin_);
+    execution_.record(executionNs);
+    overruns_ += periodNs_ != 0 && executionNs > periodNs_;
+    return executionNs;
+  }
+
+  [[nodiscard]] const LatencyHistogram& getExecutionHistogram() const { return execution_; }
+  [[nodiscard]] const LatencyHistogram& getJitterHistogram() const { return jitter_; }
+  [[nodiscard]] uint64_t getOverruns() const { return overruns_; }
+
+  [[nodiscard]] LoopStatistics getStatistics() const {
+    LoopStatistics statistics;
+    statistics.iterations = execution_.getCount();
+    statistics.overruns = overruns_;
+    statistics.executionMean = execution_.getMean();
+    statistics.executionP50 = execution_.getValueAtPercentile(50.);
+    statistics.executionP99 = execution_.getValueAtPercentile(99.);
+    statistics.executionP999 = execution_.getValueAtPercentile(99.9);
+    statistics.executionMax = execution_.getMax();
+    statistics.jitterP99 = jitter_.getValueAtPercentile(99.);
+    statistics.jitterMax = jitter_.getMax();
+    return statistics;
+  }
+
+  /// starts a new reporting interval, keeping the timestamp of the last iteration so the next period is measured
+  void reset() {
+    execution_.reset();
+    jitter_.reset();
+    overruns_ = 0;
+  }
+
+ private:
+  uint64_t periodNs_ = 0, periodCycles_ = 0;
+  uint64_t lastBegin_ = 0;
+  uint64_t overruns_ = 0;
+  LatencyHistogram execution_, jitter_;
+};
+
+}
+
+#endif // RAISIN_WS_LOOP_MONITOR_HPP_
@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_PARAMETER_HANDLE_HPP_
+#define RAISIN_WS_PARAMETER_HANDLE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace raisin {
+
+//////////////////////////////////////
+/// parameter handles
+
+/// typed parameter that a loop resolves once and then reads with a single atomic load, instead of a string
+/// lookup in a ParameterContainer per access. the metadata of params.yaml (min, max, options) is set before
+/// the handle is shared. set() may be called from any thread, e.g. by a remote parameter update, and rejects
+/// values that violate the metadata, so a reader never sees an invalid value
+template<typename T>
+class ParameterHandle {
+  static_assert(std::is_arithmetic<T>::value, "a parameter handle holds a number or a bool");
+  static_assert(std::atomic<T>::is_always_lock_free, "reading a parameter handle must not take a lock");
+
+ public:
+  explicit ParameterHandle(T val = T()) : value_(val) {}
+
+  ParameterHandle(const ParameterHandle&) = delete;
+  ParameterHandle& operator=(const ParameterHandle&) = delete;
+
+  void setRange(T min, T max) {
+    min_ = min;
+    max_ = max;
+    hasRange_ = true;
+  }
+
+  void setOptions(std::vector<T> options) { options_ = std::move(options); }
+
+  [[nodiscard]] bool isValid(T val) const {
+    if (hasRange_ && !(val >= min_ && val <= max_)) return false;
+    return options_.empty() || std::find(options_.begin(), options_.end(), val) != options_.end();
+  }
+
+  /// false if val violates the metadata, in which case the value is unchanged
+  bool set(T val) {
+    if (!isValid(val)) return false;
+    value_.store(val, std::memory_order_relaxed);
+    version_.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] T get() const { return value_.load(std::memory_order_relaxed); }
+
+  /// number of accepted sets
+  [[nodiscard]] uint64_t getVersion() const { return version_.load(std::memory_order_acquire); }
+
+  /// true once per batch of sets since version was last updated, e.g. to recompute gains only after a change.
+  /// get() afterwards returns a value at least as new as that version
+  bool changedSince(uint64_t& version) const {
+    const uint64_t current = getVersion();
+    if (current == version) return false;
+    version = current;
+    return true;
+  }
+
+ private:
+  std::atomic<T> value_;
+  std::atomic<uint64_t> version_{0};
+  T min_ = T();
+  T max_ = T();
+  bool hasRange_ = false;
+  std::vector<T> options_;
+};
+
+/// resolves parameter names to handles on the update side, so a remote update by name costs the lookup once
+/// per update instead of once per read. handles must outlive the table
+class ParameterHandleTable {
+ public:
+  template<typename T>
+  void bind(const std::string& name, ParameterHandle<T>& handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setters_[name] = [&handle](double val) {
+      if constexpr (std::is_integral<T>::value) {
+        // integer and bool parameters only accept whole numbers within the range of T. the upper bound is
+        // 2^digits, which is exact in a double unlike max() of a 64-bit T (it rounds up to 2^63 or 2^64)
+        const double upper = std::ldexp(1.0, std::numeric_limits<T>::digits);
+        if (!(val >= double(std::numeric_limits<T>::lowest()) && val < upper) || double(T(val)) != val) return false;
+      }
+      return handle.set(T(val));
+    };
+  }
+
+  /// false if name is not bound or the value was rejected
+  bool set(const std::string& name, double val) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = setters_.find(name);
+    return it != setters_.end() && it->second(val);
+  }
+
+  [[nodiscard]] bool contains(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return setters_.count(name) != 0;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::function<bool(double)>> setters_;
+};
+
+}
+
+#endif // RAISIN_WS_PARAMETER_HANDLE_HPP_
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_PENDING_REQUESTS_HPP_
+#define RAISIN_WS_PENDING_REQUESTS_HPP_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace raisin {
+
+//////////////////////////////////////
+/// pipelined requests
+
+/// client-side table of requests in flight on one connection. each request gets an id that travels with
+/// it (e.g. as MessageEnvelope::sequence) and is echoed by the service, so responses may arrive in any order.
+/// only the client side is pipelined, a service still handles the requests of a connection one at a time.
+/// callbacks run outside the table lock, on the thread that calls complete() or expire() unless an executor
+/// is given, e.g. one that posts to a SerialQueue or to the worker group that should run them
+template<typename Response>
+class PendingRequestTable {
+ public:
+  using SharedPtr = std::shared_ptr<Response>;
+  /// receives nullptr if the request timed out
+  using Callback = std::function<void(SharedPtr)>;
+  using Clock = std::chrono::steady_clock;
+  using Executor = std::function<void(std::function<void()>)>;
+
+  explicit PendingRequestTable(Executor executor = nullptr) : executor_(std::move(executor)) {}
+
+  /// registers a request and returns its id. a zero timeout never expires
+  uint32_t add(Callback callback, std::chrono::microseconds timeout = std::chrono::microseconds::zero()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // after the id wraps around, skip the ids of requests that are still pending
+    uint32_t id = nextId_++;
+    while (pending_.count(id) != 0) id = nextId_++;
+    const auto deadline = timeout.count() > 0 ? Clock::now() + timeout : Clock::time_point::max();
+    pending_.emplace(id, Entry{std::move(callback), deadline});
+    return id;
+  }
+
+  /// hands the response to its request. returns false for an unknown id, e.g. one that already expired
+  bool complete(uint32_t id, SharedPtr response) {
+    Callback callback;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pending_.find(id);
+      if (it == pending_.end()) return false;
+      callback = std::move(it->second.callback);
+      pending_.erase(it);
+    }
+    if (callback) run(std::move(callback), std::move(response));
+    return true;
+  }
+
+  /// fails every request past its deadline and returns how many
+  size_t expire(Clock::time_point now = Clock::now()) {
+    std::vector<Callback> expired;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->second.deadline <= now) {
+          expired.push_back(std::move(it->second.callback));
+          it = pending_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (auto& callback : expired)
+      if (callback) run(std::move(callback), nullptr);
+    return expired.size();
+  }
+
+  /// fails every pending request, e.g. when the connection is lost
+  void cancelAll() { expire(Clock::time_point::max()); }
+
+  [[nodiscard]] size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+  }
+
+ private:
+  struct Entry {
+    Callback callback;
+    Clock::time_point deadline;
+  };
+
+  void run(Callback callback, SharedPtr response) {
+    if (!executor_) {
+      callback(std::move(response));
+      return;
+    }
+    executor_([callback = std::move(callback), response = std::move(response)]() mutable {
+      callback(std::move(response));
+    });
+  }
+
+  Executor executor_;
+  mutable std::mutex mutex_;
+  std::unordered_map<uint32_t, Entry> pending_;
+  uint32_t nextId_ = 0;
+};
+
+}
+
+#endif // RAISIN_WS_PENDING_REQUESTS_HPP_
@@ -0,0 +1,228 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_RT_HPP_
+#define RAISIN_WS_RT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstdlib>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace raisin {
+
+//////////////////////////////////////
+/// real-time threads
+
+enum class SchedulingPolicy : uint8_t { kOther, kFifo, kRoundRobin };
+
+/// settings that affect the whole process. they are applied once, by configureRealtimeProcess() in main()
+struct RealtimeProcessConfig {
+  /// mlockall() the current and future memory of the process
+  bool lockMemory = false;
+  /// bytes of heap touched up front. on glibc this also stops malloc from returning memory to the os
+  size_t prefaultHeapSize = 0;
+};
+
+/// real-time settings of one thread group. the defaults leave a thread unchanged.
+/// threads created afterwards by the configured thread inherit its affinity and scheduling
+struct RealtimeThreadConfig {
+  /// cpus the thread may run on, empty for any
+  std::vector<int> cpus;
+  SchedulingPolicy policy = SchedulingPolicy::kOther;
+  /// 1 to 99 for kFifo and kRoundRobin
+  int priority = 0;
+  /// bytes of stack touched up front, so the loop does not take page faults later
+  size_t prefaultStackSize = 0;
+};
+
+/// parses a cpu list such as "2-3,6". an empty string is an empty list
+static inline bool parseCpuList(std::string_view text, std::vector<int>& cpus) {
+  cpus.clear();
+  while (!text.empty()) {
+    const size_t comma = std::min(text.find(','), text.size());
+    const std::string_view item = text.substr(0, comma);
+    const size_t dash = item.find('-');
+    int first = 0, last = 0;
+    const auto parse = [](std::string_view digits, int& val) {
+      if (digits.empty() || digits.size() > 6) return false;
+      val = 0;
+      for (char c : digits) {
+        if (c < '0' || c > '9') return false;
+        val = val * 10 + (c - '0');
+      }
+      return true;
+    };
+    if (dash == std::string_view::npos ? !parse(item, first)
+                                       : !parse(item.substr(0, dash), first) || !parse(item.substr(dash + 1), last))
+      return false;
+    if (dash == std::string_view::npos) last = first;
+    if (last < first) return false;
+    for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    text.remove_prefix(std::min(comma + 1, text.size()));
+  }
+  return true;
+}
+
+/// "other", "fifo" or "rr"
+static inline bool parseSchedulingPolicy(std::string_view text, SchedulingPolicy& policy) {
+  if (text == "other") policy = SchedulingPolicy::kOther;
+  else if (text == "fifo") policy = SchedulingPolicy::kFifo;
+  else if (text == "rr") policy = SchedulingPolicy::kRoundRobin;
+  else return false;
+  return true;
+}
+
+/// builds a thread group config from its params.yaml form, e.g. cpus "2-3", policy "fifo", priority 80.
+/// returns false and leaves config unchanged if a value is malformed
+static inline bool parseRealtimeThreadConfig(std::string_view cpus, std::string_view policy, int priority,
+                                             size_t prefaultStackSize, RealtimeThreadConfig& config) {
+  RealtimeThreadConfig parsed;
+  if (!parseCpuList(cpus, parsed.cpus) || !parseSchedulingPolicy(policy, parsed.policy)) return false;
+  if (parsed.policy == SchedulingPolicy::kOther ? priority != 0 : priority < 1 || priority > 99) return false;
+  parsed.priority = priority;
+  parsed.prefaultStackSize = prefaultStackSize;
+  config = std::move(parsed);
+  return true;
+}
+
+namespace internal {
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+static inline void prefaultStack(size_t size) {
+  constexpr size_t kChunkSize = 4096;
+  unsigned char chunk[kChunkSize];
+  volatile unsigned char* touched = chunk;
+  for (size_t i = 0; i < kChunkSize; i += 64) touched[i] = 0;
+  if (size > kChunkSize) prefaultStack(size - kChunkSize);
+  // a use after the call keeps this frame alive, so the recursion is not turned into a loop
+  touched[0] = 0;
+}
+
+/// shared by all translation units, unlike a static local of a static inline function
+inline std::atomic<bool> realtimeProcessConfigured{false};
+
+}  // namespace internal
+
+/// applies the process-wide settings. only the first call in a process has an effect, later calls return a warning.
+/// returns a warning for each setting the os denied or does not support, so the caller can log them and go on
+static inline std::vector<std::string> configureRealtimeProcess(const RealtimeProcessConfig& config) {
+  std::vector<std::string> warnings;
+  if (internal::realtimeProcessConfigured.exchange(true)) {
+    warnings.emplace_back("real-time process settings were already applied");
+    return warnings;
+  }
+#ifdef __linux__
+  if (config.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    warnings.push_back(std::string("mlockall: ") + std::strerror(errno));
+  if (config.prefaultHeapSize > 0) {
+#ifdef __GLIBC__
+    // keep the prefaulted pages in the process instead of returning them to the os on free
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    if (auto* heap = static_cast<volatile unsigned char*>(std::malloc(config.prefaultHeapSize))) {
+      for (size_t i = 0; i < config.prefaultHeapSize; i += 4096) heap[i] = 0;
+      std::free(const_cast<unsigned char*>(heap));
+    } else {
+      warnings.emplace_back("prefault heap: out of memory");
+    }
+  }
+#else
+  if (config.lockMemory || config.prefaultHeapSize > 0)
+    warnings.emplace_back("real-time process settings are only supported on linux");
+#endif
+  return warnings;
+}
+
+/// applies config to the calling thread only. returns a warning for each setting the os denied or does not
+/// support (e.g. SCHED_FIFO without CAP_SYS_NICE or an rtprio limit), so the caller can log them and go on
+static inline std::vector<std::string> applyRealtimeThreadConfig(const RealtimeThreadConfig& config) {
+  std::vector<std::string> warnings;
+#ifdef __linux__
+  const auto describe = [](const char* what, int error) { return std::string(what) + ": " + std::strerror(error); };
+  if (config.prefaultStackSize > 0) internal::prefaultStack(config.prefaultStackSize);
+  if (!config.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : config.cpus)
+      if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    if (const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+      warnings.push_back(describe("cpu affinity", error));
+  }
+  if (config.policy != SchedulingPolicy::kOther || config.priority != 0) {
+    const int policy = config.policy == SchedulingPolicy::kFifo         ? SCHED_FIFO
+                       : config.policy == SchedulingPolicy::kRoundRobin ? SCHED_RR
+                                                                        : SCHED_OTHER;
+    sched_param param{};
+    param.sched_priority = policy == SCHED_OTHER ? 0 : config.priority;
+    if (const int error = pthread_setschedparam(pthread_self(), policy, &param))
+      warnings.push_back(describe("scheduling policy", error));
+  }
+#else
+  if (!config.cpus.empty() || config.policy != SchedulingPolicy::kOther || config.priority != 0 ||
+      config.prefaultStackSize > 0)
+    warnings.emplace_back("real-time thread settings are only supported on linux");
+#endif
+  return warnings;
+}
+
+/// thread group name -> real-time settings, e.g. "control" on isolated cores with SCHED_FIFO and "perception"
+/// on the rest. a thread of a group calls apply() with its group name; groups without an entry are left unchanged
+class RealtimeThreadGroups {
+ public:
+  void set(const std::string& group, RealtimeThreadConfig config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    configs_[group] = std::move(config);
+  }
+
+  bool contains(const std::string& group) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return configs_.count(group) != 0;
+  }
+
+  std::vector<std::string> apply(const std::string& group) const {
+    RealtimeThreadConfig config;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = configs_.find(group);
+      if (it == configs_.end()) return {};
+      config = it->second;
+    }
+    auto warnings = applyRealtimeThreadConfig(config);
+    for (auto& warning : warnings) warning = group + ": " + warning;
+    return warnings;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, RealtimeThreadConfig> configs_;
+};
+
+}
+
+#endif // RAISIN_WS_RT_HPP_
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_SEQLOCK_HPP_
+#define RAISIN_WS_SEQLOCK_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace raisin {
+
+//////////////////////////////////////
+/// state snapshots
+
+/// single-writer seqlock over a trivially copyable T, e.g. a packed message holding a robot state or a pd target.
+/// store() never waits for readers, and load() retries only while a store is in progress, so a real-time loop
+/// can publish or read a consistent snapshot without taking a lock that another thread may hold.
+/// the value is kept in relaxed atomic words, which keeps concurrent reads of a torn value well-defined
+template<typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "a seqlock copies its value bytewise");
+  static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+ public:
+  explicit SeqLock(const T& val = T()) {
+    uint64_t words[kWordCount] = {};
+    std::memcpy(words, &val, sizeof(T));
+    for (size_t i = 0; i < kWordCount; i++) words_[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  /// only one thread may store
+  void store(const T& val) {
+    uint64_t words[kWordCount] = {};
+    std::memcpy(words, &val, sizeof(T));
+    const uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWordCount; i++) words_[i].store(words[i], std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
+  }
+
+  /// single attempt, false if a store overlapped it
+  bool tryLoad(T& val) const {
+    const uint64_t version = version_.load(std::memory_order_acquire);
+    if (version & 1) return false;
+    uint64_t words[kWordCount];
+    for (size_t i = 0; i < kWordCount; i++) words[i] = words_[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) != version) return false;
+    std::memcpy(&val, words, sizeof(T));
+    return true;
+  }
+
+  [[nodiscard]] T load() const {
+    T val;
+    while (!tryLoad(val)) {
+#if defined(__AVX2__) || defined(__SSE2__)
+      _mm_pause();
+#endif
+    }
+    return val;
+  }
+
+  /// number of completed stores, so a reader can tell whether anything changed since its last load
+  [[nodiscard]] uint64_t getVersion() const { return version_.load(std::memory_order_acquire) / 2; }
+
+ private:
+  alignas(64) std::atomic<uint64_t> version_{0};
+  std::atomic<uint64_t> words_[kWordCount];
+};
+
+}
+
+#endif // RAISIN_WS_SEQLOCK_HPP_
@@ -13,9 +13,202 @@
 #include <cstring>
 #include <type_traits>
 #include <memory>
+#include <array>
+#include <string_view>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace raisin {
 
+//////////////////////////////////////
+/// bulk copy traits
+
+template<typename T, typename = void>
+struct has_member_codec : std::false_type {};
+
+template<typename T>
+struct has_member_codec<T, std::void_t<decltype(std::declval<const T&>().getSize())>>
+    : std::true_type {};
+
+/// true if the in-memory representation of a contiguous range of T is its wire format.
+/// generated messages are excluded since they are serialized field by field, without padding.
+template<typename T>
+struct is_bulk_copyable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                   !has_member_codec<T>::value> {};
+
+template<typename T, size_t n>
+struct is_bulk_copyable<std::array<T, n>> : is_bulk_copyable<T> {};
+
+/// wire size of types whose serialized size does not depend on their value.
+/// generated fixed-size messages declare kSerializedSize.
+template<typename T, typename = void>
+struct FixedWireSize {
+  static constexpr bool value = false;
+  static constexpr uint32_t size = 0;
+};
+
+template<typename T>
+struct FixedWireSize<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static constexpr bool value = true;
+  static constexpr uint32_t size = sizeof(T);
+};
+
+template<typename T, size_t n>
+struct FixedWireSize<std::array<T, n>> {
+  static constexpr bool value = FixedWireSize<T>::value;
+  static constexpr uint32_t size = FixedWireSize<T>::size * n;
+};
+
+template<typename T>
+struct FixedWireSize<T, std::void_t<decltype(T::kSerializedSize)>> {
+  static constexpr bool value = true;
+  static constexpr uint32_t size = T::kSerializedSize;
+};
+
+/// fixed-size Eigen column vectors of @eigen fields, which are serialized like std::array
+template<typename T>
+struct FixedWireSize<T, typename std::enable_if<(T::RowsAtCompileTime > 0 && T::ColsAtCompileTime == 1)>::type> {
+  static constexpr bool value = FixedWireSize<typename T::Scalar>::value;
+  static constexpr uint32_t size = FixedWireSize<typename T::Scalar>::size * T::RowsAtCompileTime;
+};
+
+/// true for fixed-size messages whose in-memory layout is exactly their wire layout
+/// (fields in declaration order without padding), so a whole object or array is one memcpy
+template<typename T>
+struct is_packed_message
+    : std::integral_constant<bool, FixedWireSize<T>::value && has_member_codec<T>::value &&
+                                   std::is_trivially_copyable<T>::value &&
+                                   std::is_standard_layout<T>::value &&
+                                   sizeof(T) == FixedWireSize<T>::size> {};
+
+//////////////////////////////////////
+/// std::vector<bool> encodings
+
+/// the two high bits of a serialized std::vector<bool> length select its encoding.
+/// 0 is one byte per element, kBoolEncodingBitPacked is eight elements per byte (LSB first).
+/// every decoder accepts both, the bit-packed encoding is opt-in on the writer side.
+static constexpr uint32_t kBoolEncodingMask = 0xC0000000u;
+static constexpr uint32_t kBoolEncodingBitPacked = 0x80000000u;
+
+/// selects the bit-packed encoding for a std::vector<bool> field (.msg annotation @bitpacked)
+struct BitPackedBools {
+  const std::vector<bool>& val;
+};
+
+namespace internal {
+
+// libstdc++ stores std::vector<bool> as little-endian words with the first element in the lowest bit,
+// which is exactly the bit-packed wire layout
+#if defined(__GLIBCXX__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define RAISIN_BOOL_VECTOR_BYTES 1
+static inline unsigned char* boolVectorBytes(std::vector<bool>& val) {
+  return reinterpret_cast<unsigned char*>(val.begin()._M_p);
+}
+
+static inline const unsigned char* boolVectorBytes(const std::vector<bool>& val) {
+  return reinterpret_cast<const unsigned char*>(val.begin()._M_p);
+}
+#endif
+
+/// packs n bytes (zero or non-zero) into (n + 7) / 8 bytes
+static inline void packBits(const unsigned char* bytes, size_t n, unsigned char* bits) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+    const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+    std::memcpy(bits + i / 8, &mask, sizeof(uint32_t));
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    const uint16_t mask = ~static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+    std::memcpy(bits + i / 8, &mask, sizeof(uint16_t));
+  }
+#endif
+  for (; i < n; i += 8) {
+    unsigned char byte = 0;
+    for (size_t b = 0; b < 8 && i + b < n; b++) byte |= static_cast<unsigned char>(bytes[i + b] != 0) << b;
+    bits[i / 8] = byte;
+  }
+}
+
+/// expands the first n bits into n bytes of value 0 or 1
+static inline void unpackBits(const unsigned char* bits, size_t n, unsigned char* bytes) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i shuffle = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                           2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i select = _mm256_set1_epi64x(static_cast<int64_t>(0x8040201008040201ull));
+  const __m256i one = _mm256_set1_epi8(1);
+  for (; i + 32 <= n; i += 32) {
+    uint32_t mask;
+    std::memcpy(&mask, bits + i / 8, sizeof(uint32_t));
+    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int32_t>(mask)), shuffle);
+    v = _mm256_min_epu8(_mm256_and_si256(v, select), one);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes + i), v);
+  }
+#endif
+  for (; i < n; i++) bytes[i] = (bits[i / 8] >> (i % 8)) & 1;
+}
+
+/// bytes of the serialized elements for either encoding
+static inline size_t boolVectorWireSize(uint32_t header) {
+  const size_t size = header & ~kBoolEncodingMask;
+  return (header & kBoolEncodingMask) == kBoolEncodingBitPacked ? (size + 7) / 8 : size * sizeof(bool);
+}
+
+/// writes val with the encoding selected by bitPacked (no length prefix)
+static inline void encodeBools(const std::vector<bool>& val, bool bitPacked, unsigned char* out) {
+  const size_t n = val.size();
+  if (n == 0) return;
+#ifdef RAISIN_BOOL_VECTOR_BYTES
+  if (bitPacked) {
+    std::memcpy(out, boolVectorBytes(val), (n + 7) / 8);
+    if (n % 8) out[n / 8] &= static_cast<unsigned char>((1u << (n % 8)) - 1);
+  } else {
+    unpackBits(boolVectorBytes(val), n, out);
+  }
+#else
+  if (bitPacked) {
+    std::memset(out, 0, (n + 7) / 8);
+    for (size_t i = 0; i < n; i++) out[i / 8] |= static_cast<unsigned char>(val[i]) << (i % 8);
+  } else {
+    for (size_t i = 0; i < n; i++) out[i] = val[i];
+  }
+#endif
+}
+
+/// decodes n elements into val starting at element offset (a multiple of 8)
+static inline void decodeBools(const unsigned char* in, size_t n, bool bitPacked,
+                               std::vector<bool>& val, size_t offset = 0) {
+  if (n == 0) return;
+#ifdef RAISIN_BOOL_VECTOR_BYTES
+  unsigned char* out = boolVectorBytes(val) + offset / 8;
+  if (bitPacked) {
+    std::memcpy(out, in, n / 8);
+    for (size_t i = n / 8 * 8; i < n; i++) val[offset + i] = (in[i / 8] >> (i % 8)) & 1;
+  } else {
+    packBits(in, n / 8 * 8, out);
+    for (size_t i = n / 8 * 8; i < n; i++) val[offset + i] = in[i] != 0;
+  }
+#else
+  for (size_t i = 0; i < n; i++)
+    val[offset + i] = bitPacked ? (in[i / 8] >> (i % 8)) & 1 : in[i] != 0;
+#endif
+}
+
+}  // namespace internal
+
 //////////////////////////////////////
 /// getBuffer vector methods
 
@@ -42,21 +235,45 @@ static inline void setBuffer(std::vector<unsigned char>& buffer, const std::wstr
 }
 
 template<typename T>
-static inline  void setBuffer(std::vector<unsigned char>& buffer, const std::vector<T>& val) {
+static inline typename std::enable_if<is_bulk_copyable<T>::value, void>::type
+setBuffer(std::vector<unsigned char>& buffer, const std::vector<T>& val) {
+  const uint32_t size = val.size();
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + sizeof(uint32_t) + size * sizeof(T));
+  std::memcpy(buffer.data() + originalSize, &size, sizeof(uint32_t));
+  if (size > 0)
+    std::memcpy(buffer.data() + originalSize + sizeof(uint32_t), val.data(), size * sizeof(T));
+}
+
+template<typename T>
+static inline typename std::enable_if<!is_bulk_copyable<T>::value, void>::type
+setBuffer(std::vector<unsigned char>& buffer, const std::vector<T>& val) {
   setBuffer(buffer, static_cast<uint32_t>(val.size()));
   for (size_t i = 0; i<val.size(); i++) {
     setBuffer(buffer, val[i]);
   }
 }
 
+template<typename T, size_t n>
+static inline typename std::enable_if<!std::is_trivially_copyable<T>::value, void>::type
+setBuffer(std::vector<unsigned char>& buffer, const std::array<T, n>& val) {
+  for (size_t i = 0; i<n; i++) {
+    setBuffer(buffer, val[i]);
+  }
+}
+
 static inline void setBuffer(std::vector<unsigned char>& buffer, const std::vector<bool>& val) {
   setBuffer(buffer, static_cast<uint32_t>(val.size()));
   auto originalSize = buffer.size();
   buffer.resize(buffer.size() + val.size() * sizeof(bool));
-  for (size_t i = 0; i<val.size(); i++) {
-    bool temp = val[i];
-    std::memcpy(buffer.data() + originalSize + i, &temp, sizeof(bool));
-  }
+  internal::encodeBools(val, false, buffer.data() + originalSize);
+}
+
+static inline void setBuffer(std::vector<unsigned char>& buffer, BitPackedBools val) {
+  setBuffer(buffer, static_cast<uint32_t>(val.val.size()) | kBoolEncodingBitPacked);
+  auto originalSize = buffer.size();
+  buffer.resize(buffer.size() + (val.val.size() + 7) / 8);
+  internal::encodeBools(val.val, true, buffer.data() + originalSize);
 }
 
 template <typename T, typename... Args>
@@ -81,10 +298,8 @@ static unsigned char* setBuffer(unsigned char* buffer,
                              const std::string& val) {
   const uint32_t size = val.size();
   buffer = setBuffer(buffer, size);
-  for (size_t i = 0; i<size; i++) {
-    buffer = setBuffer(buffer, val[i]);
-  }
-  return buffer;
+  std::memcpy(buffer, val.data(), size);
+  return buffer + size;
 }
 
 static unsigned char* setBuffer(unsigned char* buffer,
@@ -96,8 +311,17 @@ static unsigned char* setBuffer(unsigned char* buffer,
 }
 
 template <typename T>
-static unsigned char* setBuffer(unsigned char* buffer,
-                             const std::vector<T>& val) {
+static typename std::enable_if<is_bulk_copyable<T>::value, unsigned char*>::type
+setBuffer(unsigned char* buffer, const std::vector<T>& val) {
+  const uint32_t size = val.size();
+  buffer = setBuffer(buffer, size);
+  if (size > 0) std::memcpy(buffer, val.data(), size * sizeof(T));
+  return buffer + size * sizeof(T);
+}
+
+template <typename T>
+static typename std::enable_if<!is_bulk_copyable<T>::value, unsigned char*>::type
+setBuffer(unsigned char* buffer, const std::vector<T>& val) {
   buffer = setBuffer(buffer, static_cast<uint32_t>(val.size()));
   for (size_t i = 0; i < val.size(); i++) {
     buffer = setBuffer(buffer, val[i]);
@@ -105,14 +329,26 @@ static unsigned char* setBuffer(unsigned char* buffer,
   return buffer;
 }
 
+template <typename T, size_t n>
+static typename std::enable_if<!std::is_trivially_copyable<T>::value, unsigned char*>::type
+setBuffer(unsigned char* buffer, const std::array<T, n>& val) {
+  for (size_t i = 0; i < n; i++) {
+    buffer = setBuffer(buffer, val[i]);
+  }
+  return buffer;
+}
+
 static unsigned char* setBuffer(unsigned char* buffer,
                              const std::vector<bool>& val) {
   buffer = setBuffer(buffer, static_cast<uint32_t>(val.size()));
-  for (size_t i = 0; i < val.size(); i++) {
-    bool temp = val[i];
-    buffer = setBuffer(buffer, temp);
-  }
-  return buffer;
+  internal::encodeBools(val, false, buffer);
+  return buffer + val.size() * sizeof(bool);
+}
+
+static unsigned char* setBuffer(unsigned char* buffer, BitPackedBools val) {
+  buffer = setBuffer(buffer, static_cast<uint32_t>(val.val.size()) | kBoolEncodingBitPacked);
+  internal::encodeBools(val.val, true, buffer);
+  return buffer + (val.val.size() + 7) / 8;
 }
 
 
@@ -144,8 +380,18 @@ static inline const unsigned char* getBuffer(const unsigned char* buffer,
 }
 
 template <typename T>
-static inline const unsigned char* getBuffer(const unsigned char* buffer,
-                                             std::vector<T>& val) {
+static inline typename std::enable_if<is_bulk_copyable<T>::value, const unsigned char*>::type
+getBuffer(const unsigned char* buffer, std::vector<T>& val) {
+  uint32_t size;
+  buffer = getBuffer(buffer, size);
+  val.resize(size);
+  if (size > 0) std::memcpy(val.data(), buffer, size * sizeof(T));
+  return buffer + size * sizeof(T);
+}
+
+template <typename T>
+static inline typename std::enable_if<!is_bulk_copyable<T>::value, const unsigned char*>::type
+getBuffer(const unsigned char* buffer, std::vector<T>& val) {
   uint32_t size;
   buffer = getBuffer(buffer, size);
   val.resize(size);
@@ -153,17 +399,22 @@ static inline const unsigned char* getBuffer(const unsigned char* buffer,
   return buffer;
 }
 
+template <typename T, size_t n>
+static inline typename std::enable_if<!std::is_trivially_copyable<T>::value,
+                                      const unsigned char*>::type
+getBuffer(const unsigned char* buffer, std::array<T, n>& val) {
+  for (size_t i = 0; i < n; i++) buffer = getBuffer(buffer, val[i]);
+  return buffer;
+}
+
 static inline const unsigned char* getBuffer(const unsigned char* buffer,
                                              std::vector<bool>& val) {
-  uint32_t size;
-  buffer = getBuffer(buffer, size);
-  val.resize(size);
-  for (size_t i = 0; i<val.size(); i++) {
-    bool temp;
-    std::memcpy(&temp, buffer + i * sizeof(bool), sizeof(bool));
-    val[i] = temp;
-  }
-  return buffer + size * sizeof(bool);
+  uint32_t header;
+  buffer = getBuffer(buffer, header);
+  const bool bitPacked = (header & kBoolEncodingMask) == kBoolEncodingBitPacked;
+  val.resize(header & ~kBoolEncodingMask);
+  internal::decodeBools(buffer, val.size(), bitPacked, val);
+  return buffer + internal::boolVectorWireSize(header);
 }
 
 template<typename T, typename... Args>
@@ -172,6 +423,779 @@ getBuffer(const unsigned char* buffer, T& val, Args&... rest) {
   return getBuffer(getBuffer(buffer, val), rest...);
 }
 
+//////////////////////////////////////
+/// length-aware reader methods
+
+struct BufferSegment {
+  const unsigned char* data;
+  size_t size;
+};
+
+/// sequential reader over one contiguous buffer or a chain of non-contiguous segments
+/// (e.g. received network chunks). reading past the end does not touch memory; it puts
+/// the reader into a failed state that is sticky, so a chain of reads can be checked once with ok().
+class BufferReader {
+ public:
+  BufferReader(const unsigned char* data, size_t size)
+      : single_{data, size}, segments_(&single_), segmentCount_(1) {
+    initialize();
+  }
+
+  explicit BufferReader(const std::vector<unsigned char>& buffer)
+      : BufferReader(buffer.data(), buffer.size()) {}
+
+  /// the segment array is not copied and must outlive the reader
+  BufferReader(const BufferSegment* segments, size_t segmentCount)
+      : single_{nullptr, 0}, segments_(segments), segmentCount_(segmentCount) {
+    initialize();
+  }
+
+  BufferReader(const BufferReader&) = delete;
+  BufferReader& operator=(const BufferReader&) = delete;
+
+  [[nodiscard]] inline bool ok() const { return ok_; }
+  [[nodiscard]] inline size_t getRemaining() const { return remaining_; }
+  [[nodiscard]] inline size_t getConsumed() const { return total_ - remaining_; }
+
+  /// copies the next size bytes into dst. returns false (and fails the reader) if fewer are left
+  inline bool read(void* dst, size_t size) {
+    if (!reserve(size)) return false;
+    auto* out = static_cast<unsigned char*>(dst);
+    while (size > 0) {
+      const size_t chunk = std::min(size, static_cast<size_t>(end_ - ptr_));
+      std::memcpy(out, ptr_, chunk);
+      out += chunk;
+      advance(chunk);
+      size -= chunk;
+    }
+    return true;
+  }
+
+  inline bool skip(size_t size) {
+    if (!reserve(size)) return false;
+    while (size > 0) {
+      const size_t chunk = std::min(size, static_cast<size_t>(end_ - ptr_));
+      advance(chunk);
+      size -= chunk;
+    }
+    return true;
+  }
+
+  /// marks the reader as failed, e.g. when a decoded value is inconsistent with the stream
+  inline void fail() { ok_ = false; }
+
+  /// hides all but the next size bytes (at most getRemaining()), so a length-prefixed field can be decoded in
+  /// place without reading past its end. returns the number of hidden bytes to pass to unlimit()
+  inline size_t limit(size_t size) {
+    const size_t hidden = remaining_ - std::min(size, remaining_);
+    remaining_ -= hidden;
+    total_ -= hidden;
+    return hidden;
+  }
+
+  inline void unlimit(size_t hidden) {
+    remaining_ += hidden;
+    total_ += hidden;
+  }
+
+ private:
+  inline void initialize() {
+    for (size_t i = 0; i < segmentCount_; i++) total_ += segments_[i].size;
+    remaining_ = total_;
+    if (segmentCount_ > 0) {
+      ptr_ = segments_[0].data;
+      end_ = ptr_ + segments_[0].size;
+    }
+    skipEmptySegments();
+  }
+
+  inline bool reserve(size_t size) {
+    if (!ok_ || size > remaining_) {
+      ok_ = false;
+      return false;
+    }
+    return true;
+  }
+
+  inline void advance(size_t size) {
+    ptr_ += size;
+    remaining_ -= size;
+    skipEmptySegments();
+  }
+
+  inline void skipEmptySegments() {
+    while (ptr_ == end_ && segment_ + 1 < segmentCount_) {
+      segment_++;
+      ptr_ = segments_[segment_].data;
+      end_ = ptr_ + segments_[segment_].size;
+    }
+  }
+
+  BufferSegment single_;
+  const BufferSegment* segments_;
+  size_t segmentCount_;
+  size_t segment_ = 0;
+  const unsigned char* ptr_ = nullptr;
+  const unsigned char* end_ = nullptr;
+  size_t total_ = 0;
+  size_t remaining_ = 0;
+  bool ok_ = true;
+};
+
+template <typename T>
+static inline typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+getBuffer(BufferReader& reader, T& val) {
+  return reader.read(&val, sizeof(T));
+}
+
+static inline bool getBuffer(BufferReader& reader, std::string& val) {
+  uint32_t size;
+  if (!getBuffer(reader, size)) return false;
+  if (size > reader.getRemaining()) {
+    reader.fail();
+    return false;
+  }
+  val.resize(size);
+  return reader.read(val.data(), size);
+}
+
+static inline bool getBuffer(BufferReader& reader, std::wstring& val) {
+  uint32_t sizeInBytes;
+  if (!getBuffer(reader, sizeInBytes)) return false;
+  if (sizeInBytes > reader.getRemaining() || sizeInBytes % sizeof(wchar_t) != 0) {
+    reader.fail();
+    return false;
+  }
+  val.resize(sizeInBytes / sizeof(wchar_t));
+  return reader.read(val.data(), sizeInBytes);
+}
+
+template <typename T>
+static inline typename std::enable_if<is_bulk_copyable<T>::value, bool>::type
+getBuffer(BufferReader& reader, std::vector<T>& val) {
+  uint32_t size;
+  if (!getBuffer(reader, size)) return false;
+  if (size_t(size) * sizeof(T) > reader.getRemaining()) {
+    reader.fail();
+    return false;
+  }
+  val.resize(size);
+  return reader.read(val.data(), size_t(size) * sizeof(T));
+}
+
+template <typename T>
+static inline typename std::enable_if<!is_bulk_copyable<T>::value, bool>::type
+getBuffer(BufferReader& reader, std::vector<T>& val) {
+  uint32_t size;
+  if (!getBuffer(reader, size)) return false;
+  // a corrupted length cannot force a huge allocation: grow past the remaining byte count only as elements decode
+  val.resize(std::min(size_t(size), reader.getRemaining()));
+  for (size_t i = 0; i < size; i++) {
+    if (i == val.size()) val.emplace_back();
+    if (!getBuffer(reader, val[i])) return false;
+  }
+  return true;
+}
+
+template <typename T, size_t n>
+static inline typename std::enable_if<!std::is_trivially_copyable<T>::value, bool>::type
+getBuffer(BufferReader& reader, std::array<T, n>& val) {
+  for (size_t i = 0; i < n; i++)
+    if (!getBuffer(reader, val[i])) return false;
+  return true;
+}
+
+static inline bool getBuffer(BufferReader& reader, std::vector<bool>& val) {
+  uint32_t header;
+  if (!getBuffer(reader, header)) return false;
+  const bool bitPacked = (header & kBoolEncodingMask) == kBoolEncodingBitPacked;
+  if (internal::boolVectorWireSize(header) > reader.getRemaining()) {
+    reader.fail();
+    return false;
+  }
+  val.resize(header & ~kBoolEncodingMask);
+  // decode through a stack chunk since the elements may span segments. both chunk sizes are multiples of 8 elements
+  unsigned char chunk[512];
+  const size_t elementsPerChunk = bitPacked ? sizeof(chunk) * 8 : sizeof(chunk);
+  for (size_t i = 0; i < val.size(); i += elementsPerChunk) {
+    const size_t n = std::min(elementsPerChunk, val.size() - i);
+    reader.read(chunk, bitPacked ? (n + 7) / 8 : n);
+    internal::decodeBools(chunk, n, bitPacked, val, i);
+  }
+  return reader.ok();
+}
+
+template<typename T, typename... Args>
+static inline typename std::enable_if<(sizeof...(Args) > 0), bool>::type
+getBuffer(BufferReader& reader, T& val, Args&... rest) {
+  return getBuffer(reader, val) && getBuffer(reader, rest...);
+}
+
+//////////////////////////////////////
+/// zero-copy views over serialized buffers
+
+template<typename T, typename = void>
+struct ViewTraits;
+
+/// span-like view over a serialized array of bulk-copyable elements.
+/// the received buffer gives no alignment guarantee, so elements are read by value.
+template<typename T>
+class ArrayView {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    explicit const_iterator(const unsigned char* ptr) : ptr_(ptr) {}
+    T operator*() const {
+      T val;
+      std::memcpy(&val, ptr_, sizeof(T));
+      return val;
+    }
+    const_iterator& operator++() {
+      ptr_ += sizeof(T);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto temp = *this;
+      ptr_ += sizeof(T);
+      return temp;
+    }
+    bool operator==(const const_iterator& other) const { return ptr_ == other.ptr_; }
+    bool operator!=(const const_iterator& other) const { return ptr_ != other.ptr_; }
+
+   private:
+    const unsigned char* ptr_;
+  };
+
+  ArrayView() = default;
+  ArrayView(const unsigned char* data, uint32_t size) : data_(data), size_(size) {}
+
+  [[nodiscard]] uint32_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] const unsigned char* data() const { return data_; }
+  [[nodiscard]] size_t sizeInBytes() const { return size_t(size_) * sizeof(T); }
+
+  T operator[](size_t i) const {
+    T val;
+    std::memcpy(&val, data_ + i * sizeof(T), sizeof(T));
+    return val;
+  }
+
+  const_iterator begin() const { return const_iterator(data_); }
+  const_iterator end() const { return const_iterator(data_ + sizeInBytes()); }
+
+  void copyTo(T* out) const {
+    if (size_ > 0) std::memcpy(out, data_, sizeInBytes());
+  }
+
+  /// the elements in place if the buffer is aligned for T, otherwise nullptr.
+  /// e.g. Eigen::Map<const Eigen::VectorXd>(view.alignedData(), view.size()) without a copy
+  [[nodiscard]] const T* alignedData() const {
+    return reinterpret_cast<uintptr_t>(data_) % alignof(T) == 0 ? reinterpret_cast<const T*>(data_) : nullptr;
+  }
+
+  [[nodiscard]] std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  const unsigned char* data_ = nullptr;
+  uint32_t size_ = 0;
+};
+
+/// view over a serialized std::vector<bool> in either encoding
+class BoolArrayView {
+ public:
+  BoolArrayView() = default;
+  BoolArrayView(const unsigned char* data, uint32_t header)
+      : data_(data), size_(header & ~kBoolEncodingMask),
+        bitPacked_((header & kBoolEncodingMask) == kBoolEncodingBitPacked) {}
+
+  [[nodiscard]] uint32_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] const unsigned char* data() const { return data_; }
+  [[nodiscard]] bool isBitPacked() const { return bitPacked_; }
+
+  bool operator[](size_t i) const { return bitPacked_ ? (data_[i / 8] >> (i % 8)) & 1 : data_[i] != 0; }
+
+  [[nodiscard]] std::vector<bool> toVector() const {
+    std::vector<bool> val(size_);
+    internal::decodeBools(data_, size_, bitPacked_, val);
+    return val;
+  }
+
+ private:
+  const unsigned char* data_ = nullptr;
+  uint32_t size_ = 0;
+  bool bitPacked_ = false;
+};
+
+/// view over a serialized sequence of variable-length elements (strings, messages).
+/// elements are located by walking the sequence, so random access is linear.
+template<typename T>
+class SequenceView {
+ public:
+  using element_view = typename ViewTraits<T>::type;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = element_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = element_view;
+
+    explicit const_iterator(const unsigned char* ptr) : ptr_(ptr) {}
+    element_view operator*() const { return ViewTraits<T>::view(ptr_); }
+    const_iterator& operator++() {
+      ptr_ = ViewTraits<T>::skip(ptr_);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto temp = *this;
+      ptr_ = ViewTraits<T>::skip(ptr_);
+      return temp;
+    }
+    bool operator==(const const_iterator& other) const { return ptr_ == other.ptr_; }
+    bool operator!=(const const_iterator& other) const { return ptr_ != other.ptr_; }
+
+   private:
+    const unsigned char* ptr_;
+  };
+
+  SequenceView() = default;
+  SequenceView(const unsigned char* data, const unsigned char* end, uint32_t size)
+      : data_(data), end_(end), size_(size) {}
+
+  [[nodiscard]] uint32_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] const unsigned char* data() const { return data_; }
+  [[nodiscard]] size_t sizeInBytes() const { return end_ - data_; }
+
+  element_view operator[](size_t i) const {
+    const unsigned char* temp = data_;
+    for (size_t j = 0; j < i; j++) temp = ViewTraits<T>::skip(temp);
+    return ViewTraits<T>::view(temp);
+  }
+
+  const_iterator begin() const { return const_iterator(data_); }
+  const_iterator end() const { return const_iterator(end_); }
+
+ private:
+  const unsigned char* data_ = nullptr;
+  const unsigned char* end_ = nullptr;
+  uint32_t size_ = 0;
+};
+
+/// ViewTraits<T>::type is the zero-copy view of a serialized T,
+/// view() builds it from the start of the field and skip() returns the end of the field
+template<typename T>
+struct ViewTraits<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  using type = T;
+  static inline type view(const unsigned char* buffer) {
+    T val;
+    std::memcpy(&val, buffer, sizeof(T));
+    return val;
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) { return buffer + sizeof(T); }
+};
+
+template<>
+struct ViewTraits<std::string> {
+  using type = std::string_view;
+  static inline type view(const unsigned char* buffer) {
+    uint32_t size;
+    std::memcpy(&size, buffer, sizeof(uint32_t));
+    return {reinterpret_cast<const char*>(buffer + sizeof(uint32_t)), size};
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    uint32_t size;
+    std::memcpy(&size, buffer, sizeof(uint32_t));
+    return buffer + sizeof(uint32_t) + size;
+  }
+};
+
+/// generated messages provide their own ConstView
+template<typename T>
+struct ViewTraits<T, typename std::enable_if<has_member_codec<T>::value>::type> {
+  using type = typename T::ConstView;
+  static inline type view(const unsigned char* buffer) { return type(buffer); }
+  static inline const unsigned char* skip(const unsigned char* buffer) { return type(buffer).getEnd(); }
+};
+
+template<typename T>
+struct ViewTraits<std::vector<T>> {
+  using type = typename std::conditional<is_bulk_copyable<T>::value, ArrayView<T>, SequenceView<T>>::type;
+  static inline type view(const unsigned char* buffer) {
+    uint32_t size;
+    std::memcpy(&size, buffer, sizeof(uint32_t));
+    if constexpr (is_bulk_copyable<T>::value) {
+      return type(buffer + sizeof(uint32_t), size);
+    } else {
+      return type(buffer + sizeof(uint32_t), skip(buffer), size);
+    }
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    uint32_t size;
+    std::memcpy(&size, buffer, sizeof(uint32_t));
+    buffer += sizeof(uint32_t);
+    if constexpr (is_bulk_copyable<T>::value) {
+      return buffer + size_t(size) * sizeof(T);
+    } else if constexpr (FixedWireSize<T>::value) {
+      return buffer + size_t(size) * FixedWireSize<T>::size;
+    } else {
+      for (uint32_t i = 0; i < size; i++) buffer = ViewTraits<T>::skip(buffer);
+      return buffer;
+    }
+  }
+};
+
+template<>
+struct ViewTraits<std::vector<bool>> {
+  using type = BoolArrayView;
+  static inline type view(const unsigned char* buffer) {
+    uint32_t header;
+    std::memcpy(&header, buffer, sizeof(uint32_t));
+    return type(buffer + sizeof(uint32_t), header);
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    uint32_t header;
+    std::memcpy(&header, buffer, sizeof(uint32_t));
+    return buffer + sizeof(uint32_t) + internal::boolVectorWireSize(header);
+  }
+};
+
+template<typename T, size_t n>
+struct ViewTraits<std::array<T, n>> {
+  using type = typename std::conditional<is_bulk_copyable<T>::value, ArrayView<T>, SequenceView<T>>::type;
+  static inline type view(const unsigned char* buffer) {
+    if constexpr (is_bulk_copyable<T>::value) {
+      return type(buffer, n);
+    } else {
+      return type(buffer, skip(buffer), n);
+    }
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    if constexpr (is_bulk_copyable<T>::value) {
+      return buffer + n * sizeof(T);
+    } else if constexpr (FixedWireSize<T>::value) {
+      return buffer + n * FixedWireSize<T>::size;
+    } else {
+      for (size_t i = 0; i < n; i++) buffer = ViewTraits<T>::skip(buffer);
+      return buffer;
+    }
+  }
+};
+
+//////////////////////////////////////
+/// scatter-gather methods
+
+/// builds a list of segments for vectored writes (writev/sendmsg). small values are copied
+/// into an internal buffer while contiguous fields of at least minReferenceSize bytes are
+/// referenced in place, so they must stay alive and unmodified until the segments are sent.
+/// clear() keeps the allocated capacity, so a writer reused per message does not allocate.
+class SegmentWriter {
+ public:
+  explicit SegmentWriter(size_t minReferenceSize = 4096) : minReferenceSize_(minReferenceSize) {}
+
+  inline void clear() {
+    inline_.clear();
+    entries_.clear();
+    size_ = 0;
+  }
+
+  /// copies size bytes into the internal buffer
+  inline void append(const void* data, size_t size) {
+    if (size == 0) return;
+    std::memcpy(appendUninitialized(size), data, size);
+  }
+
+  /// returns space for size bytes in the internal buffer. valid until the next call on the writer
+  inline unsigned char* appendUninitialized(size_t size) {
+    const size_t offset = inline_.size();
+    inline_.resize(offset + size);
+    if (!entries_.empty() && entries_.back().external == nullptr)
+      entries_.back().size += size;
+    else
+      entries_.push_back({nullptr, offset, size});
+    size_ += size;
+    return inline_.data() + offset;
+  }
+
+  /// references the bytes in place if they are large enough, otherwise copies them
+  inline void reference(const void* data, size_t size) {
+    if (size < minReferenceSize_) {
+      append(data, size);
+      return;
+    }
+    entries_.push_back({static_cast<const unsigned char*>(data), 0, size});
+    size_ += size;
+  }
+
+  [[nodiscard]] inline size_t getSize() const { return size_; }
+
+  /// resolves the segments in order. the result is invalidated by any further append
+  [[nodiscard]] inline const std::vector<BufferSegment>& getSegments() {
+    segments_.clear();
+    for (const auto& entry : entries_)
+      segments_.push_back({entry.external ? entry.external : inline_.data() + entry.offset, entry.size});
+    return segments_;
+  }
+
+  /// copies all segments into one contiguous buffer, e.g. for a transport without vectored writes
+  inline void gather(std::vector<unsigned char>& buffer) {
+    const size_t originalSize = buffer.size();
+    buffer.resize(originalSize + size_);
+    unsigned char* out = buffer.data() + originalSize;
+    for (const auto& segment : getSegments()) {
+      std::memcpy(out, segment.data, segment.size);
+      out += segment.size;
+    }
+  }
+
+ private:
+  struct Entry {
+    const unsigned char* external;
+    size_t offset;
+    size_t size;
+  };
+
+  std::vector<unsigned char> inline_;
+  std::vector<Entry> entries_;
+  std::vector<BufferSegment> segments_;
+  size_t minReferenceSize_;
+  size_t size_ = 0;
+};
+
+template<typename T>
+static inline typename std::enable_if<is_bulk_copyable<T>::value, void>::type
+appendSegments(SegmentWriter& writer, const T& val) {
+  writer.append(&val, sizeof(T));
+}
+
+static inline void appendSegments(SegmentWriter& writer, const std::string& val) {
+  const uint32_t size = val.size();
+  writer.append(&size, sizeof(uint32_t));
+  writer.reference(val.data(), size);
+}
+
+static inline void appendSegments(SegmentWriter& writer, const std::wstring& val) {
+  const uint32_t size = val.size() * sizeof(wchar_t);
+  writer.append(&size, sizeof(uint32_t));
+  writer.reference(val.data(), size);
+}
+
+template<typename T>
+static inline typename std::enable_if<is_bulk_copyable<T>::value, void>::type
+appendSegments(SegmentWriter& writer, const std::vector<T>& val) {
+  const uint32_t size = val.size();
+  writer.append(&size, sizeof(uint32_t));
+  writer.reference(val.data(), size * sizeof(T));
+}
+
+template<typename T>
+static inline typename std::enable_if<!is_bulk_copyable<T>::value, void>::type
+appendSegments(SegmentWriter& writer, const std::vector<T>& val) {
+  const uint32_t size = val.size();
+  writer.append(&size, sizeof(uint32_t));
+  for (const auto& v : val) appendSegments(writer, v);
+}
+
+template<typename T, size_t n>
+static inline typename std::enable_if<!std::is_trivially_copyable<T>::value, void>::type
+appendSegments(SegmentWriter& writer, const std::array<T, n>& val) {
+  for (const auto& v : val) appendSegments(writer, v);
+}
+
+static inline void appendSegments(SegmentWriter& writer, const std::vector<bool>& val) {
+  const uint32_t size = val.size();
+  writer.append(&size, sizeof(uint32_t));
+  internal::encodeBools(val, false, writer.appendUninitialized(size * sizeof(bool)));
+}
+
+static inline void appendSegments(SegmentWriter& writer, BitPackedBools val) {
+  const uint32_t header = static_cast<uint32_t>(val.val.size()) | kBoolEncodingBitPacked;
+  writer.append(&header, sizeof(uint32_t));
+  internal::encodeBools(val.val, true, writer.appendUninitialized((val.val.size() + 7) / 8));
+}
+
+//////////////////////////////////////
+/// structure of arrays
+
+/// a T[] field annotated with @soa is generated as one std::vector column per field of T (bool as uint8_t).
+/// it is serialized as [uint32 count] followed by each column as count contiguous values, so encoding and
+/// decoding a column is a single memcpy. the generated columns provide setBuffer, getBuffer, appendSegments
+/// and getSize, and all columns must have the same length
+template<typename T>
+struct StructOfArraysRef {
+  T& val;
+};
+
+/// ViewTraits key of a @soa field. its view is a decoded copy
+template<typename T>
+struct StructOfArrays {};
+
+namespace internal {
+
+template<typename T>
+static inline unsigned char* setColumn(unsigned char* buffer, const std::vector<T>& column, size_t count) {
+  if (count > 0) std::memcpy(buffer, column.data(), count * sizeof(T));
+  return buffer + count * sizeof(T);
+}
+
+template<typename T>
+static inline const unsigned char* getColumn(const unsigned char* buffer, std::vector<T>& column, size_t count) {
+  column.resize(count);
+  if (count > 0) std::memcpy(static_cast<void*>(column.data()), buffer, count * sizeof(T));
+  return buffer + count * sizeof(T);
+}
+
+/// the caller checks that count values remain
+template<typename T>
+static inline void getColumn(BufferReader& reader, std::vector<T>& column, size_t count) {
+  column.resize(count);
+  reader.read(static_cast<void*>(column.data()), count * sizeof(T));
+}
+
+template<typename T>
+static inline void appendColumn(SegmentWriter& writer, const std::vector<T>& column, size_t count) {
+  writer.reference(column.data(), count * sizeof(T));
+}
+
+}  // namespace internal
+
+template<typename T>
+static inline unsigned char* setBuffer(unsigned char* buffer, StructOfArraysRef<T> field) {
+  return field.val.setBuffer(buffer);
+}
+
+template<typename T>
+static inline void setBuffer(std::vector<unsigned char>& buffer, StructOfArraysRef<T> field) {
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + field.val.getSize());
+  field.val.setBuffer(buffer.data() + originalSize);
+}
+
+template<typename T>
+static inline const unsigned char* getBuffer(const unsigned char* buffer, StructOfArraysRef<T> field) {
+  return field.val.getBuffer(buffer);
+}
+
+template<typename T>
+static inline bool getBuffer(BufferReader& reader, StructOfArraysRef<T> field) {
+  return field.val.getBuffer(reader);
+}
+
+template<typename T>
+static inline void appendSegments(SegmentWriter& writer, StructOfArraysRef<T> field) {
+  field.val.appendSegments(writer);
+}
+
+template<typename T>
+struct ViewTraits<StructOfArrays<T>> {
+  using type = T;
+  static inline type view(const unsigned char* buffer) {
+    T val;
+    val.getBuffer(buffer);
+    return val;
+  }
+  static inline const unsigned char* skip(const unsigned char* buffer) {
+    uint32_t count;
+    std::memcpy(&count, buffer, sizeof(uint32_t));
+    return buffer + sizeof(uint32_t) + size_t(count) * T::kRowSize;
+  }
+};
+
+//////////////////////////////////////
+/// Eigen vectors
+
+/// a numeric T[N] or T[] field annotated with @eigen is generated as Eigen::Matrix<T, N, 1, Eigen::DontAlign>
+/// or Eigen::Matrix<T, Eigen::Dynamic, 1>. the wire format is the one of std::array<T, N> and std::vector<T>,
+/// so both sides need not agree on the annotation, and the values are copied with one memcpy.
+/// Eigen itself is only included by the generated messages that use it
+template<typename T>
+struct EigenVectorRef {
+  T& val;
+};
+
+/// operator== of Eigen asserts on vectors of different sizes
+template<typename A, typename B>
+static inline bool eigenVectorsEqual(const A& a, const B& b) {
+  return a.size() == b.size() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+namespace internal {
+
+template<typename T>
+static inline constexpr bool isDynamicEigenVector() {
+  return std::remove_const<T>::type::RowsAtCompileTime < 0;
+}
+
+}  // namespace internal
+
+template<typename T>
+static inline unsigned char* setBuffer(unsigned char* buffer, EigenVectorRef<T> field) {
+  using Scalar = typename std::remove_const<T>::type::Scalar;
+  const auto size = static_cast<uint32_t>(field.val.size());
+  if constexpr (internal::isDynamicEigenVector<T>()) {
+    std::memcpy(buffer, &size, sizeof(uint32_t));
+    buffer += sizeof(uint32_t);
+  }
+  if (size > 0) std::memcpy(buffer, field.val.data(), size_t(size) * sizeof(Scalar));
+  return buffer + size_t(size) * sizeof(Scalar);
+}
+
+template<typename T>
+static inline void setBuffer(std::vector<unsigned char>& buffer, EigenVectorRef<T> field) {
+  using Scalar = typename std::remove_const<T>::type::Scalar;
+  const size_t originalSize = buffer.size();
+  buffer.resize(originalSize + size_t(field.val.size()) * sizeof(Scalar) +
+                (internal::isDynamicEigenVector<T>() ? sizeof(uint32_t) : 0));
+  setBuffer(buffer.data() + originalSize, field);
+}
+
+template<typename T>
+static inline const unsigned char* getBuffer(const unsigned char* buffer, EigenVectorRef<T> field) {
+  using Scalar = typename T::Scalar;
+  if constexpr (internal::isDynamicEigenVector<T>()) {
+    uint32_t size;
+    std::memcpy(&size, buffer, sizeof(uint32_t));
+    buffer += sizeof(uint32_t);
+    field.val.resize(size);
+  }
+  const size_t sizeInBytes = size_t(field.val.size()) * sizeof(Scalar);
+  if (sizeInBytes > 0) std::memcpy(field.val.data(), buffer, sizeInBytes);
+  return buffer + sizeInBytes;
+}
+
+template<typename T>
+static inline bool getBuffer(BufferReader& reader, EigenVectorRef<T> field) {
+  using Scalar = typename T::Scalar;
+  if constexpr (internal::isDynamicEigenVector<T>()) {
+    uint32_t size;
+    if (!getBuffer(reader, size)) return false;
+    if (size_t(size) * sizeof(Scalar) > reader.getRemaining()) {
+      reader.fail();
+      return false;
+    }
+    field.val.resize(size);
+  }
+  return reader.read(field.val.data(), size_t(field.val.size()) * sizeof(Scalar));
+}
+
+template<typename T>
+static inline void appendSegments(SegmentWriter& writer, EigenVectorRef<T> field) {
+  using Scalar = typename std::remove_const<T>::type::Scalar;
+  if constexpr (internal::isDynamicEigenVector<T>()) {
+    const auto size = static_cast<uint32_t>(field.val.size());
+    writer.append(&size, sizeof(uint32_t));
+  }
+  writer.reference(field.val.data(), size_t(field.val.size()) * sizeof(Scalar));
+}
+
 struct MessageInformation {
   int64_t timestamp;
   std::string title;
@@ -198,9 +1222,10 @@ struct SerializedMessage
 {
   SerializedMessage() {}
 
-  uint32_t size()
+  /// bytes written by setBuffer
+  uint32_t size() const
   {
-    return sizeof(int64_t) + sizeof(uint32_t) + msg.size();
+    return sizeof(uint32_t) + title.size() + sizeof(int32_t) + sizeof(uint32_t) + msg.size();
   }
 
   std::string title, dataType;
@@ -219,6 +1244,285 @@ static inline const unsigned char * getBuffer(const unsigned char * buffer, Seri
   return getBuffer(buffer, val.title, val.id, val.msg);
 }
 
+//////////////////////////////////////
+/// compact message envelope
+
+/// fixed-size header sent in front of each payload instead of the topic and type strings.
+/// topicId is agreed on when the subscription is set up (see TopicIdTable), typeHash is the kTypeHash
+/// of the payload type and payloadSize is the number of payload bytes that follow the header.
+struct MessageEnvelope {
+  static constexpr size_t kHeaderSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) +
+                                        sizeof(uint32_t) + sizeof(uint32_t);
+
+  uint32_t topicId = 0;
+  uint64_t typeHash = 0;
+  int64_t timestamp = 0;
+  uint32_t sequence = 0;
+  uint32_t payloadSize = 0;
+};
+
+static inline unsigned char* setBuffer(unsigned char* buffer, const MessageEnvelope& val) {
+  buffer = setBuffer(buffer, val.topicId);
+  buffer = setBuffer(buffer, val.typeHash);
+  buffer = setBuffer(buffer, val.timestamp);
+  buffer = setBuffer(buffer, val.sequence);
+  return setBuffer(buffer, val.payloadSize);
+}
+
+static inline void setBuffer(std::vector<unsigned char>& buffer, const MessageEnvelope& val) {
+  auto originalSize = buffer.size();
+  buffer.resize(originalSize + MessageEnvelope::kHeaderSize);
+  setBuffer(buffer.data() + originalSize, val);
+}
+
+static inline const unsigned char* getBuffer(const unsigned char* buffer, MessageEnvelope& val) {
+  buffer = getBuffer(buffer, val.topicId);
+  buffer = getBuffer(buffer, val.typeHash);
+  buffer = getBuffer(buffer, val.timestamp);
+  buffer = getBuffer(buffer, val.sequence);
+  return getBuffer(buffer, val.payloadSize);
+}
+
+/// also fails if fewer than payloadSize bytes follow the header
+static inline bool getBuffer(BufferReader& reader, MessageEnvelope& val) {
+  if (reader.getRemaining() < MessageEnvelope::kHeaderSize) {
+    reader.fail();
+    return false;
+  }
+  unsigned char header[MessageEnvelope::kHeaderSize];
+  reader.read(header, sizeof(header));
+  getBuffer(header, val);
+  if (val.payloadSize > reader.getRemaining()) reader.fail();
+  return reader.ok();
+}
+
+/// writes the envelope and the payload with a single resize. typeHash and payloadSize are taken from msg
+template<typename T>
+static inline void setEnvelopeBuffer(std::vector<unsigned char>& buffer, MessageEnvelope envelope, const T& msg) {
+  auto originalSize = buffer.size();
+  buffer.resize(originalSize + MessageEnvelope::kHeaderSize + msg.getSize());
+  unsigned char* payload = buffer.data() + originalSize + MessageEnvelope::kHeaderSize;
+  const unsigned char* end = msg.setBuffer(payload);
+  envelope.typeHash = T::kTypeHash;
+  envelope.payloadSize = static_cast<uint32_t>(end - payload);
+  setBuffer(buffer.data() + originalSize, envelope);
+  buffer.resize(end - buffer.data());
+}
+
+/// assigns consecutive topic ids on the publisher side and resolves them on the subscriber side
+class TopicIdTable {
+ public:
+  /// returns the id of title, assigning the next free one on first use
+  uint32_t intern(const std::string& title) {
+    auto it = ids_.find(title);
+    if (it != ids_.end()) return it->second;
+    titles_.push_back(title);
+    return ids_[title] = static_cast<uint32_t>(titles_.size() - 1);
+  }
+
+  /// records an id announced by the other side. a title that moves to a new id no longer resolves from its old
+  /// one, and a title that held id before is forgotten
+  void assign(uint32_t id, const std::string& title) {
+    auto it = ids_.find(title);
+    if (it != ids_.end() && it->second != id) titles_[it->second].clear();
+    if (id >= titles_.size()) titles_.resize(id + 1);
+    if (!titles_[id].empty() && titles_[id] != title) ids_.erase(titles_[id]);
+    titles_[id] = title;
+    ids_[title] = id;
+  }
+
+  /// nullptr for an unknown id
+  [[nodiscard]] const std::string* find(uint32_t id) const {
+    return id < titles_.size() && !titles_[id].empty() ? &titles_[id] : nullptr;
+  }
+
+  [[nodiscard]] bool find(const std::string& title, uint32_t& id) const {
+    auto it = ids_.find(title);
+    if (it == ids_.end()) return false;
+    id = it->second;
+    return true;
+  }
+
+ private:
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::vector<std::string> titles_;
+};
+
+//////////////////////////////////////
+/// delta encoding
+
+/// publisher side of a delta-encoded topic. each frame is [uint32 sequence][uint8 keyframe][delta],
+/// where the delta holds only the fields that changed since the previous frame (T::setBufferDelta).
+/// every keyframeInterval-th frame is a keyframe so a receiver that lost a frame can resynchronize.
+template<typename T>
+class DeltaEncoder {
+ public:
+  explicit DeltaEncoder(uint32_t keyframeInterval = 100) : keyframeInterval_(keyframeInterval) {}
+
+  /// appends the frame of msg to buffer
+  void encode(const T& msg, std::vector<unsigned char>& buffer) {
+    const bool keyframe = forceKeyframe_ || (keyframeInterval_ != 0 && sequence_ % keyframeInterval_ == 0);
+    setBuffer(buffer, sequence_);
+    setBuffer(buffer, static_cast<uint8_t>(keyframe));
+    msg.setBufferDelta(buffer, previous_, keyframe);
+    previous_ = msg;
+    forceKeyframe_ = false;
+    sequence_++;
+  }
+
+  /// makes the next frame a keyframe, e.g. when a subscriber joins
+  void requestKeyframe() { forceKeyframe_ = true; }
+
+ private:
+  T previous_{};
+  uint32_t keyframeInterval_;
+  uint32_t sequence_ = 0;
+  bool forceKeyframe_ = true;
+};
+
+/// subscriber side of a delta-encoded topic
+template<typename T>
+class DeltaDecoder {
+ public:
+  /// returns false if the frame is incomplete or follows a lost frame. decoding resumes at the next keyframe
+  bool decode(BufferReader& reader) {
+    uint32_t sequence;
+    uint8_t keyframe;
+    if (!getBuffer(reader, sequence) || !getBuffer(reader, keyframe)) return false;
+    if (!keyframe && (!synced_ || sequence != expected_)) {
+      synced_ = false;
+      return false;
+    }
+    synced_ = current_.applyDelta(reader);
+    expected_ = sequence + 1;
+    return synced_;
+  }
+
+  bool decode(const unsigned char* buffer, size_t size) {
+    BufferReader reader(buffer, size);
+    return decode(reader);
+  }
+
+  /// the latest decoded message
+  [[nodiscard]] const T& get() const { return current_; }
+  [[nodiscard]] bool isSynced() const { return synced_; }
+
+ private:
+  T current_{};
+  uint32_t expected_ = 0;
+  bool synced_ = false;
+};
+
+//////////////////////////////////////
+/// message pool
+
+/// fixed-capacity pool of T that hands out shared pointers whose objects and control blocks are recycled.
+/// an object keeps its previous contents, so decoding into it with getBuffer() reuses the capacity of its
+/// std::vector and std::string members and a steady stream of messages does not touch the heap.
+/// acquire() is lock-free and may be called from any thread. when every node is in use it falls back to
+/// std::make_shared. outstanding pointers keep the storage alive after the pool itself is destroyed.
+template<typename T>
+class MessagePool {
+ public:
+  using SharedPtr = std::shared_ptr<T>;
+
+  explicit MessagePool(size_t capacity = 64) : impl_(std::make_shared<Impl>(capacity)) {}
+
+  /// returns a recycled object, or a new one if the pool is exhausted
+  [[nodiscard]] SharedPtr acquire() {
+    const uint32_t index = impl_->pop();
+    if (index == kNone) return std::make_shared<T>();
+    Node& node = impl_->nodes[index];
+    return SharedPtr(&node.object, [](T*) {}, Allocator<T>{impl_, index});
+  }
+
+  /// returns a recycled object decoded from buffer
+  [[nodiscard]] SharedPtr acquire(const unsigned char* buffer) {
+    SharedPtr msg = acquire();
+    msg->getBuffer(buffer);
+    return msg;
+  }
+
+  [[nodiscard]] size_t getCapacity() const { return impl_->nodes.size(); }
+
+  /// number of idle objects. only a snapshot while other threads acquire or release
+  [[nodiscard]] size_t getAvailable() const {
+    size_t count = 0;
+    for (uint32_t i = static_cast<uint32_t>(impl_->head.load()); i != kNone; i = impl_->nodes[i].next.load())
+      count++;
+    return count;
+  }
+
+ private:
+  static constexpr uint32_t kNone = 0xFFFFFFFFu;
+  // room for libstdc++/libc++/MSVC control blocks of a stateless deleter and this allocator
+  static constexpr size_t kControlBlockSize = 64;
+
+  struct Node {
+    T object;
+    alignas(std::max_align_t) unsigned char controlBlock[kControlBlockSize];
+    std::atomic<uint32_t> next{kNone};
+  };
+
+  // treiber stack of node indices. the upper 32 bits of head are a tag that avoids ABA
+  struct Impl {
+    explicit Impl(size_t capacity) : nodes(capacity) {
+      for (size_t i = 0; i < capacity; i++) push(static_cast<uint32_t>(i));
+    }
+
+    uint32_t pop() {
+      uint64_t old = head.load(std::memory_order_acquire);
+      while (static_cast<uint32_t>(old) != kNone) {
+        const uint64_t next = ((old >> 32) + 1) << 32 | nodes[static_cast<uint32_t>(old)].next.load(std::memory_order_relaxed);
+        if (head.compare_exchange_weak(old, next, std::memory_order_acquire, std::memory_order_acquire)) break;
+      }
+      return static_cast<uint32_t>(old);
+    }
+
+    void push(uint32_t index) {
+      uint64_t old = head.load(std::memory_order_relaxed);
+      uint64_t next;
+      do {
+        nodes[index].next.store(static_cast<uint32_t>(old), std::memory_order_relaxed);
+        next = ((old >> 32) + 1) << 32 | index;
+      } while (!head.compare_exchange_weak(old, next, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::vector<Node> nodes;
+    std::atomic<uint64_t> head{kNone};
+  };
+
+  // places the control block inside the node and releases the node once the control block is gone,
+  // i.e. after the last shared and weak reference
+  template<typename U>
+  struct Allocator {
+    using value_type = U;
+
+    Allocator(std::shared_ptr<Impl> impl, uint32_t index) : impl(std::move(impl)), index(index) {}
+    template<typename V>
+    Allocator(const Allocator<V>& other) : impl(other.impl), index(other.index) {}
+
+    U* allocate(size_t n) {
+      static_assert(sizeof(U) <= kControlBlockSize && alignof(U) <= alignof(std::max_align_t),
+                    "shared_ptr control block does not fit into the pool node");
+      (void)n;
+      return reinterpret_cast<U*>(impl->nodes[index].controlBlock);
+    }
+
+    void deallocate(U*, size_t) { impl->push(index); }
+
+    template<typename V>
+    bool operator==(const Allocator<V>& other) const { return impl == other.impl && index == other.index; }
+    template<typename V>
+    bool operator!=(const Allocator<V>& other) const { return !(*this == other); }
+
+    std::shared_ptr<Impl> impl;
+    uint32_t index;
+  };
+
+  std::shared_ptr<Impl> impl_;
+};
+
 }
 
 #endif // RAISIN_WS_SERIALIZATION_BASE_HPP_
\ No newline at end of file
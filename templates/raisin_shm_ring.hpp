@@ -0,0 +1,322 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_SHM_RING_HPP_
+#define RAISIN_WS_SHM_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "raisin_serialization_base.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// shared-memory loans
+
+/// single-writer ring of fixed-size slots inside a memory region shared by processes on one host, e.g. the
+/// named segment of raisin_network/shared_memory.hpp. the writer loans a free slot, builds the message in
+/// place and publishes it without copying. readers lease published slots read-only, and a slot is only
+/// reused once its reference count drops to zero. a message overwritten before a reader got to it counts
+/// as lost for that reader. a process that dies while holding a lease keeps that slot out of the ring
+class SharedMemoryRing {
+  static constexpr uint64_t kMagic = 0x52534d52494e4731ull;
+  static constexpr uint32_t kWriterBit = 0x80000000u;
+  static constexpr size_t kAlignment = 64;
+
+  struct RingHeader {
+    std::atomic<uint64_t> magic;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    std::atomic<uint64_t> publishedCount;
+  };
+
+  struct alignas(kAlignment) SlotHeader {
+    std::atomic<uint32_t> refCount;
+    uint32_t size;
+    std::atomic<uint64_t> sequence;
+    uint64_t typeHash;
+  };
+
+  static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                "shared-memory atomics must be lock-free");
+
+  static constexpr size_t alignUp(size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+ public:
+  /// slots are indexed with 16 bits in the published list
+  static constexpr uint32_t kMaxSlotCount = 0xFFFF;
+  /// returned by publish() for a loan it rejected
+  static constexpr uint64_t kNoSequence = ~uint64_t(0);
+
+  class Lease;
+
+  /// a slot owned by the writer until it is published. dropping an unpublished loan returns the slot
+  class Loan {
+   public:
+    Loan() = default;
+    Loan(Loan&& other) noexcept { *this = std::move(other); }
+    Loan& operator=(Loan&& other) noexcept {
+      reset();
+      ring_ = other.ring_;
+      slot_ = other.slot_;
+      size_ = other.size_;
+      typeHash_ = other.typeHash_;
+      other.ring_ = nullptr;
+      return *this;
+    }
+    Loan(const Loan&) = delete;
+    Loan& operator=(const Loan&) = delete;
+    ~Loan() { reset(); }
+
+    explicit operator bool() const { return ring_ != nullptr; }
+    [[nodiscard]] unsigned char* data() const { return ring_->slotData(slot_); }
+    [[nodiscard]] size_t getCapacity() const { return ring_->getSlotSize(); }
+
+    /// sets the number of raw bytes written to data()
+    void setSize(size_t size, uint64_t typeHash = 0) {
+      size_ = static_cast<uint32_t>(std::min(size, getCapacity()));
+      typeHash_ = typeHash;
+    }
+
+    /// constructs a packed message in the slot, whose memory is also its wire format
+    template<typename T>
+    T& construct() {
+      static_assert(is_packed_message<T>::value, "only packed messages can be built in place, use setMessage()");
+      static_assert(alignof(T) <= kAlignment, "slots are 64-byte aligned");
+      setSize(sizeof(T), T::kTypeHash);
+      return *new (data()) T();
+    }
+
+    /// serializes msg straight into the slot. false if it does not fit
+    template<typename T>
+    bool setMessage(const T& msg) {
+      if (msg.getSize() > getCapacity()) return false;
+      setSize(msg.setBuffer(data()) - data(), T::kTypeHash);
+      return true;
+    }
+
+   private:
+    friend class SharedMemoryRing;
+    Loan(SharedMemoryRing* ring, uint32_t slot) : ring_(ring), slot_(slot) {}
+
+    void reset() {
+      if (ring_) ring_->slotHeader(slot_)->refCount.store(0, std::memory_order_release);
+      ring_ = nullptr;
+    }
+
+    SharedMemoryRing* ring_ = nullptr;
+    uint32_t slot_ = 0;
+    uint32_t size_ = 0;
+    uint64_t typeHash_ = 0;
+  };
+
+  /// read-only reference to a published slot, released on destruction
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(Lease&& other) noexcept { *this = std::move(other); }
+    Lease& operator=(Lease&& other) noexcept {
+      reset();
+      ring_ = other.ring_;
+      slot_ = other.slot_;
+      sequence_ = other.sequence_;
+      other.ring_ = nullptr;
+      return *this;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { reset(); }
+
+    explicit operator bool() const { return ring_ != nullptr; }
+    [[nodiscard]] const unsigned char* data() const { return ring_->slotData(slot_); }
+    [[nodiscard]] size_t getSize() const { return ring_->slotHeader(slot_)->size; }
+    [[nodiscard]] uint64_t getTypeHash() const { return ring_->slotHeader(slot_)->typeHash; }
+    [[nodiscard]] uint64_t getSequence() const { return sequence_; }
+
+    /// nullptr unless the slot holds a packed T built with Loan::construct() or setMessage()
+    template<typename T>
+    [[nodiscard]] const T* get() const {
+      static_assert(is_packed_message<T>::value, "use view() for messages that are not packed");
+      if (getTypeHash() != T::kTypeHash || getSize() != sizeof(T)) return nullptr;
+      return reinterpret_cast<const T*>(data());
+    }
+
+    /// decodes fields on access, without copying the slot
+    template<typename T>
+    [[nodiscard]] typename T::ConstView view() const {
+      return typename T::ConstView(data());
+    }
+
+    void reset() {
+      if (ring_) ring_->slotHeader(slot_)->refCount.fetch_sub(1, std::memory_order_release);
+      ring_ = nullptr;
+    }
+
+   private:
+    friend class SharedMemoryRing;
+    SharedMemoryRing* ring_ = nullptr;
+    uint32_t slot_ = 0;
+    uint64_t sequence_ = 0;
+  };
+
+  /// bytes of region needed for slotCount slots of slotSize bytes
+  static constexpr size_t getRequiredSize(uint32_t slotCount, uint32_t slotSize) {
+    return alignUp(sizeof(RingHeader) + slotCount * sizeof(std::atomic<uint64_t>)) +
+           size_t(slotCount) * (alignUp(sizeof(SlotHeader)) + alignUp(slotSize));
+  }
+
+  SharedMemoryRing() = default;
+
+  /// initializes a new ring in region, which must be 64-byte aligned and getRequiredSize() large.
+  /// done once by the writer before any reader attaches
+  bool create(void* region, size_t regionSize, uint32_t slotCount, uint32_t slotSize) {
+    if (slotCount == 0 || slotCount > kMaxSlotCount || regionSize < getRequiredSize(slotCount, slotSize) ||
+        reinterpret_cast<uintptr_t>(region) % kAlignment != 0)
+      return false;
+    base_ = static_cast<unsigned char*>(region);
+    auto* header = new (base_) RingHeader();
+    header->magic.store(0, std::memory_order_relaxed);
+    header->slotCount = slotCount;
+    header->slotSize = static_cast<uint32_t>(alignUp(slotSize));
+    header->publishedCount.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < slotCount; i++) new (&published()[i]) std::atomic<uint64_t>(kNoSequence);
+    layout(*header);
+    for (uint32_t i = 0; i < slotCount; i++) {
+      auto* slot = new (slotHeader(i)) SlotHeader();
+      slot->refCount.store(0, std::memory_order_relaxed);
+      slot->size = 0;
+      slot->sequence.store(kNoSequence, std::memory_order_relaxed);
+      slot->typeHash = 0;
+    }
+    header->magic.store(kMagic, std::memory_order_release);
+    return true;
+  }
+
+  /// uses a ring created by another process. readers start at the newest published message
+  bool attach(void* region, size_t regionSize) {
+    auto* header = static_cast<RingHeader*>(region);
+    if (regionSize < sizeof(RingHeader) || header->magic.load(std::memory_order_acquire) != kMagic ||
+        regionSize < getRequiredSize(header->slotCount, header->slotSize))
+      return false;
+    base_ = static_cast<unsigned char*>(region);
+    layout(*header);
+    const uint64_t count = header->publishedCount.load(std::memory_order_acquire);
+    nextSequence_ = count == 0 ? 0 : count - 1;
+    return true;
+  }
+
+  [[nodiscard]] uint32_t getSlotCount() const { return slotCount_; }
+  [[nodiscard]] size_t getSlotSize() const { return ringHeader()->slotSize; }
+
+  /// writer side. an empty loan if every slot is being read
+  Loan loan() {
+    for (uint32_t i = 0; i < slotCount_; i++) {
+      const uint32_t slot = (loanCursor_ + 1 + i) % slotCount_;
+      uint32_t expected = 0;
+      auto* header = slotHeader(slot);
+      if (header->refCount.compare_exchange_strong(expected, kWriterBit, std::memory_order_acquire)) {
+        header->sequence.store(kNoSequence, std::memory_order_relaxed);
+        loanCursor_ = slot;
+        return Loan(this, slot);
+      }
+    }
+    return Loan();
+  }
+
+  /// hands the slot over to the readers and empties loan. returns the sequence number of the message, or
+  /// kNoSequence without touching the ring if loan is empty, moved-from or was loaned by another ring
+  uint64_t publish(Loan&& loan) {
+    if (!loan || loan.ring_ != this) return kNoSequence;
+    auto* header = slotHeader(loan.slot_);
+    const uint64_t sequence = ringHeader()->publishedCount.load(std::memory_order_relaxed);
+    header->size = loan.size_;
+    header->typeHash = loan.typeHash_;
+    header->sequence.store(sequence, std::memory_order_relaxed);
+    header->refCount.store(0, std::memory_order_release);
+    const uint32_t slot = loan.slot_;
+    loan.ring_ = nullptr;
+    loan.slot_ = loan.size_ = 0;
+    loan.typeHash_ = 0;
+    published()[sequence % slotCount_].store((sequence << 16) | slot, std::memory_order_release);
+    ringHeader()->publishedCount.store(sequence + 1, std::memory_order_release);
+    return sequence;
+  }
+
+  /// reader side. leases the next message of this reader, skipping overwritten ones. false if there is none yet
+  bool acquireNext(Lease& lease) {
+    lease.reset();
+    const uint64_t count = ringHeader()->publishedCount.load(std::memory_order_acquire);
+    if (nextSequence_ + slotCount_ < count) {
+      lostCount_ += count - slotCount_ - nextSequence_;
+      nextSequence_ = count - slotCount_;
+    }
+    for (; nextSequence_ < count; nextSequence_++) {
+      if (tryAcquire(nextSequence_, lease)) {
+        nextSequence_++;
+        return true;
+      }
+      lostCount_++;
+    }
+    return false;
+  }
+
+  /// messages this reader skipped because they were overwritten first
+  [[nodiscard]] uint64_t getLostCount() const { return lostCount_; }
+
+ private:
+  friend class Loan;
+  friend class Lease;
+
+  void layout(const RingHeader& header) {
+    slotCount_ = header.slotCount;
+    slotsOffset_ = alignUp(sizeof(RingHeader) + slotCount_ * sizeof(std::atomic<uint64_t>));
+    slotStride_ = alignUp(sizeof(SlotHeader)) + header.slotSize;
+  }
+
+  bool tryAcquire(uint64_t sequence, Lease& lease) {
+    const uint64_t entry = published()[sequence % slotCount_].load(std::memory_order_acquire);
+    if (entry == kNoSequence || (entry >> 16) != sequence) return false;
+    const auto slot = static_cast<uint32_t>(entry & 0xFFFF);
+    auto* header = slotHeader(slot);
+    uint32_t refCount = header->refCount.load(std::memory_order_relaxed);
+    do {
+      if (refCount & kWriterBit) return false;
+    } while (!header->refCount.compare_exchange_weak(refCount, refCount + 1, std::memory_order_acquire));
+    if (header->sequence.load(std::memory_order_relaxed) != sequence) {
+      header->refCount.fetch_sub(1, std::memory_order_release);
+      return false;
+    }
+    lease.ring_ = this;
+    lease.slot_ = slot;
+    lease.sequence_ = sequence;
+    return true;
+  }
+
+  [[nodiscard]] RingHeader* ringHeader() const { return reinterpret_cast<RingHeader*>(base_); }
+  [[nodiscard]] std::atomic<uint64_t>* published() const {
+    return reinterpret_cast<std::atomic<uint64_t>*>(base_ + sizeof(RingHeader));
+  }
+  [[nodiscard]] SlotHeader* slotHeader(uint32_t slot) const {
+    return reinterpret_cast<SlotHeader*>(base_ + slotsOffset_ + slot * slotStride_);
+  }
+  [[nodiscard]] unsigned char* slotData(uint32_t slot) const {
+    return base_ + slotsOffset_ + slot * slotStride_ + alignUp(sizeof(SlotHeader));
+  }
+
+  unsigned char* base_ = nullptr;
+  uint32_t slotCount_ = 0;
+  size_t slotsOffset_ = 0, slotStride_ = 0;
+  uint32_t loanCursor_ = 0;
+  uint64_t nextSequence_ = 0, lostCount_ = 0;
+};
+
+}
+
+#endif // RAISIN_WS_SHM_RING_HPP_
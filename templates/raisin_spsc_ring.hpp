@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_SPSC_RING_HPP_
+#define RAISIN_WS_SPSC_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace raisin {
+
+//////////////////////////////////////
+/// single-producer single-consumer ring
+
+/// lock-free ring between one producer thread and one consumer thread. the capacity is rounded up to a
+/// power of two and every slot is a copy of prototype made up front, so a slot keeps its capacity and
+/// neither side allocates or waits. give prototype its largest size: a copied std::vector keeps the size
+/// of the original but not what was only reserve()d
+template<typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity, const T& prototype = T()) {
+    size_t slotCount = 1;
+    while (slotCount < capacity) slotCount *= 2;
+    slots_.assign(slotCount, prototype);
+    mask_ = slotCount - 1;
+  }
+
+  /// producer side. fill(T&) writes the new element in place. false if the ring is full
+  template<typename Fill>
+  bool tryProduce(Fill&& fill) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tailCache_ == slots_.size()) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head - tailCache_ == slots_.size()) return false;
+    }
+    fill(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const T& val) {
+    return tryProduce([&](T& slot) { slot = val; });
+  }
+
+  /// consumer side. consume(T&) reads the oldest element before its slot is reused. false if the ring is empty
+  template<typename Consume>
+  bool tryConsume(Consume&& consume) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == headCache_) {
+      headCache_ = head_.load(std::memory_order_acquire);
+      if (tail == headCache_) return false;
+    }
+    consume(slots_[tail & mask_]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T& val) {
+    return tryConsume([&](T& slot) { std::swap(val, slot); });
+  }
+
+  [[nodiscard]] size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] size_t capacity() const { return slots_.size(); }
+
+ private:
+  std::vector<T> slots_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tailCache_ = 0;
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t headCache_ = 0;
+};
+
+}
+
+#endif // RAISIN_WS_SPSC_RING_HPP_
@@ -0,0 +1,184 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_TIMED_LOOP_HPP_
+#define RAISIN_WS_TIMED_LOOP_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "raisin_loop_monitor.hpp"
+
+namespace raisin {
+
+//////////////////////////////////////
+/// timed loops
+
+/// what a timed loop does when an iteration ends after its next deadline
+enum class OverrunPolicy : uint8_t {
+  /// drop the missed iterations and wait for the next deadline on the original grid
+  kSkip,
+  /// run the missed iterations back to back until the loop is on schedule again
+  kCatchUp,
+  /// run one iteration right away and shift the grid by the overrun
+  kRunLate
+};
+
+/// sleeps until spinThreshold before deadline and spins for the rest, which trades a little cpu time for
+/// wake-up jitter in the microseconds instead of the scheduler tick
+static inline void sleepUntil(std::chrono::steady_clock::time_point deadline,
+                              std::chrono::steady_clock::duration spinThreshold = std::chrono::microseconds(100)) {
+  if (deadline - std::chrono::steady_clock::now() > spinThreshold) std::this_thread::sleep_until(deadline - spinThreshold);
+  while (std::chrono::steady_clock::now() < deadline) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+}
+
+/// runs the timed loops of one thread against absolute deadlines, so the period does not drift with the
+/// execution time or wake-up latency. the due loop with the earliest deadline runs first, and every loop
+/// has a LoopMonitor for its execution time, jitter and overruns. not thread-safe, one scheduler per thread,
+/// except for stop()
+class TimedLoopScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit TimedLoopScheduler(Clock::duration spinThreshold = std::chrono::microseconds(100))
+      : spinThreshold_(spinThreshold) {}
+
+  TimedLoopScheduler(const TimedLoopScheduler&) = delete;
+  TimedLoopScheduler& operator=(const TimedLoopScheduler&) = delete;
+
+  /// rate in Hz. the first iteration is due right away and the loop gets the id getLoopCount() - 1.
+  /// false for an empty callback or a rate that is not positive and finite or whose period is below a clock tick
+  bool addLoop(std::string name, std::function<void()> callback, double rate,
+               OverrunPolicy policy = OverrunPolicy::kSkip) {
+    if (!callback || !(rate > 0.) || !std::isfinite(rate)) return false;
+    Loop loop;
+    loop.period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / rate));
+    if (loop.period <= Clock::duration::zero()) return false;
+    loop.name = std::move(name);
+    loop.callback = std::move(callback);
+    loop.policy = policy;
+    loop.deadline = Clock::now();
+    loop.monitor.setRate(rate);
+    loops_.push_back(std::move(loop));
+    return true;
+  }
+
+  /// waits for the earliest deadline and runs that loop. false if there are no loops or stop() was called,
+  /// in which case it returns without waiting out the deadline
+  bool runNext() {
+    if (loops_.empty()) return false;
+    Loop* next = &loops_.front();
+    for (auto& loop : loops_)
+      if (loop.deadline < next->deadline) next = &loop;
+    if (!waitUntil(next->deadline)) return false;
+
+    next->monitor.begin();
+    next->callback();
+    next->monitor.end();
+    next->runCount++;
+
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point deadline = next->deadline;
+    next->deadline += next->period;
+    if (next->deadline <= now) {
+      switch (next->policy) {
+        case OverrunPolicy::kSkip: {
+          const auto missed = (now - deadline) / next->period;
+          next->deadline = deadline + next->period * (missed + 1);
+          next->skippedCount += static_cast<uint64_t>(missed);
+          break;
+        }
+        case OverrunPolicy::kCatchUp:
+          break;
+        case OverrunPolicy::kRunLate:
+          next->deadline = now;
+          break;
+      }
+    }
+    return true;
+  }
+
+  /// runs loops until stop() is called
+  void run() {
+    while (runNext()) {
+    }
+  }
+
+  /// may be called from any thread. wakes a waiting runNext() right away, a running callback is finished first.
+  /// the scheduler stays stopped
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_.store(true, std::memory_order_relaxed);
+    }
+    wakeup_.notify_all();
+  }
+
+  [[nodiscard]] bool isStopped() const { return stopping_.load(std::memory_order_relaxed); }
+
+  [[nodiscard]] size_t getLoopCount() const { return loops_.size(); }
+  [[nodiscard]] const std::string& getName(size_t id) const { return loops_[id].name; }
+  [[nodiscard]] uint64_t getRunCount(size_t id) const { return loops_[id].runCount; }
+  /// iterations dropped by OverrunPolicy::kSkip
+  [[nodiscard]] uint64_t getSkippedCount(size_t id) const { return loops_[id].skippedCount; }
+  [[nodiscard]] LoopMonitor& getMonitor(size_t id) { return loops_[id].monitor; }
+  [[nodiscard]] Clock::time_point getDeadline(size_t id) const { return loops_[id].deadline; }
+
+ private:
+  struct Loop {
+    std::string name;
+    std::function<void()> callback;
+    Clock::duration period{};
+    OverrunPolicy policy = OverrunPolicy::kSkip;
+    Clock::time_point deadline;
+    uint64_t runCount = 0, skippedCount = 0;
+    LoopMonitor monitor;
+  };
+
+  /// sleepUntil() that stop() can interrupt. false if it was
+  bool waitUntil(Clock::time_point deadline) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto stopping = [this] { return stopping_.load(std::memory_order_relaxed); };
+      if (wakeup_.wait_until(lock, deadline - spinThreshold_, stopping)) return false;
+    }
+    while (Clock::now() < deadline) {
+      if (stopping_.load(std::memory_order_relaxed)) return false;
+#if defined(__AVX2__) || defined(__SSE2__)
+      _mm_pause();
+#endif
+    }
+    return true;
+  }
+
+  Clock::duration spinThreshold_;
+  std::vector<Loop> loops_;
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::atomic<bool> stopping_{false};
+};
+
+}
+
+#endif // RAISIN_WS_TIMED_LOOP_HPP_
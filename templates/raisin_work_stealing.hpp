@@ -0,0 +1,256 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+#ifndef RAISIN_WS_WORK_STEALING_HPP_
+#define RAISIN_WS_WORK_STEALING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace raisin {
+
+//////////////////////////////////////
+/// work stealing
+
+/// Chase-Lev deque of pointers with a fixed power-of-two capacity. the owning thread pushes and pops at the
+/// bottom, other threads steal from the top. this is the weak memory model version of Le et al. (PPoPP 2013)
+template<typename T>
+class ChaseLevDeque {
+ public:
+  explicit ChaseLevDeque(size_t capacity = 1024) {
+    size_t slotCount = 1;
+    while (slotCount < capacity) slotCount *= 2;
+    slots_ = std::make_unique<std::atomic<T*>[]>(slotCount);
+    mask_ = static_cast<int64_t>(slotCount - 1);
+  }
+
+  /// owner only. false if the deque is full
+  bool push(T* item) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top > mask_) return false;
+    slots_[bottom & mask_].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// owner only. the newest item, nullptr if empty
+  T* pop() {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = slots_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        item = nullptr;
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /// any thread. the oldest item, nullptr if empty or another thief won the race
+  T* steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+    T* item = slots_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return nullptr;
+    return item;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::unique_ptr<std::atomic<T*>[]> slots_;
+  int64_t mask_ = 0;
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+/// workers that share one steal domain. a task submitted from a worker goes to the deque of that worker,
+/// others go to a shared queue, and a worker that runs out of tasks steals from its peers. a task may run
+/// on any worker, so callbacks that need their order kept go through a SerialQueue
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingPool(size_t workerCount, size_t dequeCapacity = 4096) {
+    workerCount = std::max<size_t>(workerCount, 1);
+    for (size_t i = 0; i < workerCount; i++) workers_.push_back(std::make_unique<Worker>(dequeCapacity));
+    for (size_t i = 0; i < workerCount; i++) workers_[i]->thread = std::thread([this, i] { run(i); });
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /// runs the tasks that are still queued, then joins the workers
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+  }
+
+  void submit(Task task) {
+    auto* item = new Task(std::move(task));
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    Worker* worker = currentWorker();
+    if (!(worker && worker->pool == this && worker->deque.push(item))) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      injected_.push_back(item);
+    }
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wakeup_.notify_one();
+    }
+  }
+
+  [[nodiscard]] size_t getWorkerCount() const { return workers_.size(); }
+  /// tasks that ran on a different worker than the one they were queued on
+  [[nodiscard]] uint64_t getStolenCount() const { return stolen_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Worker {
+    explicit Worker(size_t dequeCapacity) : deque(dequeCapacity) {}
+    ChaseLevDeque<Task> deque;
+    WorkStealingPool* pool = nullptr;
+    std::thread thread;
+  };
+
+  static inline Worker*& currentWorker() {
+    static thread_local Worker* worker = nullptr;
+    return worker;
+  }
+
+  Task* take(size_t index) {
+    if (Task* item = workers_[index]->deque.pop()) return item;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!injected_.empty()) {
+        Task* item = injected_.front();
+        injected_.pop_front();
+        return item;
+      }
+    }
+    for (size_t i = 1; i < workers_.size(); i++) {
+      if (Task* item = workers_[(index + i) % workers_.size()]->deque.steal()) {
+        stolen_.fetch_add(1, std::memory_order_relaxed);
+        return item;
+      }
+    }
+    return nullptr;
+  }
+
+  void run(size_t index) {
+    workers_[index]->pool = this;
+    currentWorker() = workers_[index].get();
+    while (true) {
+      if (Task* item = take(index)) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        (*item)();
+        delete item;
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleeping_.fetch_add(1, std::memory_order_seq_cst);
+      // a task that is counted but not pushed yet makes the predicate true, so the worker retries
+      wakeup_.wait_for(lock, std::chrono::milliseconds(1), [this] {
+        return stopping_ || pending_.load(std::memory_order_seq_cst) > 0;
+      });
+      sleeping_.fetch_sub(1, std::memory_order_relaxed);
+      if (stopping_ && pending_.load(std::memory_order_seq_cst) == 0) break;
+    }
+    currentWorker() = nullptr;
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<Task*> injected_;
+  bool stopping_ = false;
+  std::atomic<int64_t> pending_{0};
+  std::atomic<int> sleeping_{0};
+  std::atomic<uint64_t> stolen_{0};
+};
+
+/// runs the tasks posted to it one at a time and in order on any worker of a WorkStealingPool, e.g. the
+/// callbacks of one subscriber. at most maxBatch tasks run per turn so a busy queue does not hold a worker.
+/// the queue must outlive its pending tasks
+class SerialQueue {
+ public:
+  explicit SerialQueue(WorkStealingPool& pool, size_t maxBatch = 16) : pool_(pool), maxBatch_(maxBatch) {}
+
+  void post(WorkStealingPool::Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    if (!scheduled_) {
+      scheduled_ = true;
+      pool_.submit([this] { drain(); });
+    }
+  }
+
+  /// true while tasks are queued or running
+  [[nodiscard]] bool isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scheduled_;
+  }
+
+ private:
+  void drain() {
+    for (size_t i = 0; i < maxBatch_; i++) {
+      WorkStealingPool::Task task;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) {
+          scheduled_ = false;
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty())
+      scheduled_ = false;
+    else
+      pool_.submit([this] { drain(); });
+  }
+
+  WorkStealingPool& pool_;
+  size_t maxBatch_;
+  mutable std::mutex mutex_;
+  std::deque<WorkStealingPool::Task> tasks_;
+  bool scheduled_ = false;
+};
+
+}
+
+#endif // RAISIN_WS_WORK_STEALING_HPP_
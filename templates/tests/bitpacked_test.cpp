@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// round trips of @bitpacked std::vector<bool> fields through every decoder, around the
+// lengths where the SIMD pack and unpack paths switch
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "raisin_test_msgs/msg/flags.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::Flags;
+
+int main() {
+  std::mt19937 rng(1);
+  for (size_t n : {0, 1, 7, 8, 9, 31, 32, 33, 63, 64, 65, 100, 1000, 40000}) {
+    Flags flags;
+    flags.packed.resize(n);
+    flags.plain.resize(n + 3);
+    for (size_t i = 0; i < flags.packed.size(); i++) flags.packed[i] = rng() & 1;
+    for (size_t i = 0; i < flags.plain.size(); i++) flags.plain[i] = rng() & 1;
+
+    std::vector<unsigned char> buffer;
+    flags.setBuffer(buffer);
+    RAISIN_CHECK(buffer.size() == flags.getSize());
+    // eight bools per byte for the packed field, one per byte for the plain one
+    RAISIN_CHECK(buffer.size() == 4 + (n + 7) / 8 + 4 + (n + 3));
+
+    Flags decoded;
+    decoded.getBuffer(buffer.data());
+    RAISIN_CHECK(decoded == flags);
+
+    std::vector<BufferSegment> segments;
+    for (size_t i = 0; i < buffer.size(); i += 37)
+      segments.push_back({buffer.data() + i, std::min<size_t>(37, buffer.size() - i)});
+    BufferReader reader(segments.data(), segments.size());
+    Flags segmented;
+    RAISIN_CHECK(segmented.getBuffer(reader) && segmented == flags && reader.getRemaining() == 0);
+
+    BufferReader truncated(buffer.data(), buffer.size() - 1);
+    Flags partial;
+    RAISIN_CHECK(!partial.getBuffer(truncated));
+
+    Flags::ConstView view(buffer.data());
+    RAISIN_CHECK(view.packed().isBitPacked() && !view.plain().isBitPacked());
+    RAISIN_CHECK(view.packed().toVector() == flags.packed && view.plain().toVector() == flags.plain);
+    for (size_t i = 0; i < n; i++) RAISIN_CHECK(view.packed()[i] == flags.packed[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// round trips of @compress fields, with or without lz4 and zstd compiled in, a crafted header
+// whose plain size does not fit its stored bytes, and uncompressed fields that must end at their stored size
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "raisin_test_msgs/msg/grid.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::Grid;
+
+static void testRoundTrip() {
+  Grid grid{};
+  grid.cells.assign(size_t(1) << 17, 3);
+  for (size_t i = 0; i < grid.cells.size(); i += 7) grid.cells[i] = static_cast<uint8_t>(i);
+  grid.heights.assign(5000, 1.25f);
+  grid.names = {"a", "bb", "ccc"};
+  // below the threshold, so stored uncompressed
+  grid.small = {1, 2, 3};
+  grid.id = 7;
+
+  std::vector<unsigned char> buffer;
+  grid.setBuffer(buffer);
+  RAISIN_CHECK(buffer.size() <= grid.getSize());
+
+  Grid decoded;
+  decoded.getBuffer(buffer.data());
+  RAISIN_CHECK(decoded == grid);
+
+  std::vector<BufferSegment> segments;
+  for (size_t i = 0; i < buffer.size(); i += 1000)
+    segments.push_back({buffer.data() + i, std::min<size_t>(1000, buffer.size() - i)});
+  BufferReader reader(segments.data(), segments.size());
+  Grid segmented;
+  RAISIN_CHECK(segmented.getBuffer(reader) && segmented == grid && reader.getRemaining() == 0);
+
+  Grid::ConstView view(buffer);
+  RAISIN_CHECK(view.cells() == grid.cells && view.heights() == grid.heights && view.id() == 7);
+
+  BufferReader truncated(buffer.data(), buffer.size() - 1);
+  Grid partial;
+  RAISIN_CHECK(!partial.getBuffer(truncated));
+}
+
+static void testCraftedPlainSize() {
+  // an lz4 header claiming 3 GB of plain data for 8 stored bytes must be rejected before allocating
+  unsigned char buffer[9 + 8] = {};
+  buffer[0] = static_cast<unsigned char>(Compression::kLz4);
+  const uint32_t plainSize = 3000000000u, storedSize = 8;
+  std::memcpy(buffer + 1, &plainSize, sizeof(plainSize));
+  std::memcpy(buffer + 5, &storedSize, sizeof(storedSize));
+
+  std::vector<float> values;
+  BufferReader reader(buffer, sizeof(buffer));
+  RAISIN_CHECK(!getBuffer(reader, CompressedFieldRef<std::vector<float>>{values}));
+  RAISIN_CHECK(values.capacity() < 1024);
+}
+
+static void testUncompressedBounds() {
+  // an uncompressed float[] of 2 values (12 bytes) followed by 4 more bytes of the stream
+  unsigned char buffer[9 + 12 + 4] = {};
+  buffer[0] = static_cast<unsigned char>(Compression::kNone);
+  const uint32_t count = 2, next = 0xabcdef;
+  std::memcpy(buffer + 9, &count, sizeof(count));
+  std::memcpy(buffer + 21, &next, sizeof(next));
+  const auto decode = [&](uint32_t storedSize, std::vector<float>& values) {
+    std::memcpy(buffer + 1, &storedSize, sizeof(storedSize));
+    std::memcpy(buffer + 5, &storedSize, sizeof(storedSize));
+    BufferReader reader(buffer, sizeof(buffer));
+    const bool decoded = getBuffer(reader, CompressedFieldRef<std::vector<float>>{values});
+    uint32_t rest = 0;
+    return decoded && getBuffer(reader, rest) && rest == next && reader.getRemaining() == 0;
+  };
+  std::vector<float> values;
+  RAISIN_CHECK(decode(12, values) && values.size() == 2);
+  // the field may neither read past its stored bytes nor leave some of them unread
+  RAISIN_CHECK(!decode(8, values));
+  RAISIN_CHECK(!decode(16, values));
+}
+
+int main() {
+  testRoundTrip();
+  testCraftedPlainSize();
+  testUncompressedBounds();
+  return 0;
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// fragmentation and reassembly of datagrams: shuffled and lost fragments, interleaved messages,
+// malformed datagrams, fragments at inconsistent offsets and a restarted publisher
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "raisin_datagram.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+using Datagrams = std::vector<std::vector<unsigned char>>;
+
+static Datagrams fragment(DatagramFragmenter& fragmenter, const std::vector<unsigned char>& message) {
+  Datagrams datagrams;
+  RAISIN_CHECK(fragmenter.fragment(message.data(), message.size(), [&](const unsigned char* data, size_t size) {
+    datagrams.emplace_back(data, data + size);
+  }));
+  return datagrams;
+}
+
+static void testShuffledAndLost() {
+  std::mt19937 rng(1);
+  DatagramFragmenter fragmenter(3);
+  DatagramReassembler reassembler;
+  std::vector<std::vector<unsigned char>> messages(50);
+  size_t delivered = 0;
+
+  for (size_t i = 0; i < messages.size(); i++) {
+    messages[i].resize(rng() % 20000);
+    for (auto& byte : messages[i]) byte = static_cast<unsigned char>(rng());
+    Datagrams datagrams = fragment(fragmenter, messages[i]);
+    for (const auto& datagram : datagrams) RAISIN_CHECK(datagram.size() <= DatagramFragmenter::kDefaultDatagramSize);
+    std::shuffle(datagrams.begin(), datagrams.end(), rng);
+
+    // every tenth message loses its first datagram
+    const bool drop = i % 10 == 5;
+    for (size_t k = drop ? 1 : 0; k < datagrams.size(); k++) {
+      RAISIN_CHECK(reassembler.receive(datagrams[k].data(), datagrams[k].size(),
+                                       [&](const DatagramHeader& header, const unsigned char* message, size_t size) {
+        RAISIN_CHECK(header.topicId == 3 && header.sequence < messages.size());
+        const auto& sent = messages[header.sequence];
+        RAISIN_CHECK(size == sent.size() && (size == 0 || std::memcmp(message, sent.data(), size) == 0));
+        delivered++;
+      }));
+    }
+  }
+  RAISIN_CHECK(delivered == 45 && reassembler.getReceivedCount() == 45 && reassembler.getLostCount() == 5);
+  RAISIN_CHECK(reassembler.getLossRatio() > 0.09 && reassembler.getLossRatio() < 0.11);
+}
+
+static void testInterleavedAndLate() {
+  DatagramFragmenter fragmenter(4, 200);
+  DatagramReassembler reassembler;
+  const std::vector<unsigned char> first(1000, 1), second(900, 2);
+  const Datagrams a = fragment(fragmenter, first), b = fragment(fragmenter, second);
+  std::vector<uint32_t> sequences;
+  const auto deliver = [&](const DatagramHeader& header, const unsigned char*, size_t) {
+    sequences.push_back(header.sequence);
+  };
+  for (size_t k = 0; k < std::max(a.size(), b.size()); k++) {
+    if (k < b.size()) reassembler.receive(b[k].data(), b[k].size(), deliver);
+    if (k < a.size()) reassembler.receive(a[k].data(), a[k].size(), deliver);
+  }
+  // the second message completes first, so the rest of the first one is late
+  RAISIN_CHECK(sequences == std::vector<uint32_t>({1}));
+  RAISIN_CHECK(reassembler.getLateCount() > 0);
+}
+
+static void testMalformed() {
+  DatagramReassembler reassembler;
+  unsigned char junk[64] = {};
+  const auto fail = [](const DatagramHeader&, const unsigned char*, size_t) { RAISIN_CHECK(false); };
+  RAISIN_CHECK(!reassembler.receive(junk, 5, fail));
+  // a zero fragment count
+  RAISIN_CHECK(!reassembler.receive(junk, sizeof(junk), fail));
+}
+
+static void testInconsistentOffsets() {
+  DatagramFragmenter fragmenter(5, DatagramHeader::kHeaderSize + 100);
+  std::vector<unsigned char> message(350);
+  for (size_t i = 0; i < message.size(); i++) message[i] = static_cast<unsigned char>(i);
+  const Datagrams datagrams = fragment(fragmenter, message);
+  RAISIN_CHECK(datagrams.size() == 4);
+  const auto withOffset = [](std::vector<unsigned char> datagram, uint32_t offset) {
+    // topicId, sequence and messageSize come first
+    std::memcpy(datagram.data() + 3 * sizeof(uint32_t), &offset, sizeof(offset));
+    return datagram;
+  };
+
+  DatagramReassembler reassembler;
+  size_t delivered = 0;
+  const auto check = [&](const DatagramHeader&, const unsigned char* data, size_t size) {
+    RAISIN_CHECK(size == message.size() && std::memcmp(data, message.data(), size) == 0);
+    delivered++;
+  };
+  const std::vector<std::vector<unsigned char>> forged = {
+      // overlaps the first fragment
+      withOffset(datagrams[1], 50),
+      // the payload of the second fragment at the offset of the third
+      withOffset(datagrams[1], 200),
+      // the last fragment at an offset that is not a multiple of its index, or that runs past the message
+      withOffset(datagrams[3], 301),
+      withOffset(datagrams[3], 320),
+  };
+  for (const auto& datagram : forged) RAISIN_CHECK(!reassembler.receive(datagram.data(), datagram.size(), check));
+  // a fragment whose payload disagrees with one already received for the message
+  RAISIN_CHECK(reassembler.receive(datagrams[0].data(), datagrams[0].size(), check));
+  const auto shorter = std::vector<unsigned char>(datagrams[1].begin(), datagrams[1].end() - 10);
+  RAISIN_CHECK(!reassembler.receive(withOffset(shorter, 90).data(), shorter.size(), check));
+
+  for (size_t k = 1; k < datagrams.size(); k++)
+    RAISIN_CHECK(reassembler.receive(datagrams[k].data(), datagrams[k].size(), check));
+  RAISIN_CHECK(delivered == 1);
+}
+
+static void testRestart() {
+  const std::vector<unsigned char> message(10, 7);
+  DatagramReassembler reassembler;
+  DatagramFragmenter before(1);
+  for (int i = 0; i < 100; i++)
+    for (const auto& datagram : fragment(before, message))
+      reassembler.receive(datagram.data(), datagram.size(), [](const DatagramHeader&, const unsigned char*, size_t) {});
+
+  // a restarted publisher counts from 0 again, which looks late until the reassembler resynchronizes
+  DatagramFragmenter after(1);
+  size_t delivered = 0;
+  for (int i = 0; i < 30; i++)
+    for (const auto& datagram : fragment(after, message))
+      reassembler.receive(datagram.data(), datagram.size(),
+                          [&](const DatagramHeader&, const unsigned char*, size_t) { delivered++; });
+  RAISIN_CHECK(reassembler.getLateCount() == DatagramReassembler::kMaxLateRun);
+  RAISIN_CHECK(delivered == 30 - DatagramReassembler::kMaxLateRun);
+}
+
+int main() {
+  testShuffledAndLost();
+  testInterleavedAndLate();
+  testMalformed();
+  testInconsistentOffsets();
+  testRestart();
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// delta encoding against a previous message, and the keyframe recovery of DeltaEncoder and
+// DeltaDecoder after a lost frame
+
+#include <vector>
+
+#include "raisin_test_msgs/msg/cloud.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::Cloud;
+
+static void testDelta() {
+  Cloud previous{};
+  previous.name = "cloud";
+  previous.data = {1., 2.};
+  previous.points.resize(2);
+  Cloud current = previous;
+  current.data.push_back(3.);
+  current.origin.x = 5.;
+
+  std::vector<unsigned char> delta, full;
+  current.setBufferDelta(delta, previous);
+  current.setBuffer(full);
+  RAISIN_CHECK(delta.size() < full.size() / 2);
+
+  Cloud applied = previous;
+  RAISIN_CHECK(applied.applyDelta(delta.data()) == delta.data() + delta.size());
+  RAISIN_CHECK(applied == current);
+
+  Cloud read = previous;
+  BufferReader reader(delta);
+  RAISIN_CHECK(read.applyDelta(reader) && read == current && reader.getRemaining() == 0);
+
+  // an unchanged message is only the change mask
+  std::vector<unsigned char> unchanged;
+  previous.setBufferDelta(unchanged, previous);
+  RAISIN_CHECK(unchanged.size() == Cloud::kDeltaMaskSize);
+}
+
+static void testLostFrame() {
+  DeltaEncoder<Cloud> encoder(4);
+  DeltaDecoder<Cloud> decoder;
+  Cloud message{};
+  for (int i = 0; i < 20; i++) {
+    message.origin.y = i;
+    if (i % 3 == 0) message.tags.push_back("tag");
+    std::vector<unsigned char> frame;
+    encoder.encode(message, frame);
+    if (i == 5) {
+      RAISIN_CHECK(!decoder.decode(nullptr, 0));
+      continue;
+    }
+    // the deltas after the lost frame are refused until the keyframe at 8
+    const bool decoded = decoder.decode(frame.data(), frame.size());
+    if (i < 5 || i >= 8) {
+      RAISIN_CHECK(decoded && decoder.get() == message);
+    } else {
+      RAISIN_CHECK(!decoded);
+    }
+  }
+}
+
+int main() {
+  testDelta();
+  testLostFrame();
+  return 0;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// round trips of @eigen fields, whose wire format is that of the std::array or std::vector they replace,
+// so a peer without the annotation has the same type hash and reads the same bytes
+
+#include <cstring>
+#include <vector>
+
+#include "raisin_test_msgs/msg/plain_state.hpp"
+#include "raisin_test_msgs/msg/state.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::PlainState;
+using raisin_test_msgs::msg::State;
+
+int main() {
+  State state;
+  RAISIN_CHECK(state.gc.isZero() && state.quat.isZero() && state.gv.size() == 0);
+  const Eigen::VectorXd gc = Eigen::VectorXd::LinSpaced(19, 0, 18);
+  state.gc = gc;
+  state.gv = Eigen::VectorXd::Constant(18, 2.5);
+  state.quat << 1, 0, 0, 0;
+  state.id = 7;
+
+  std::vector<unsigned char> buffer;
+  state.setBuffer(buffer);
+  RAISIN_CHECK(buffer.size() == state.getSize());
+  RAISIN_CHECK(buffer.size() == 19 * 8 + 4 + 18 * 8 + 4 * 4 + 4);
+  double last = 0.;
+  std::memcpy(&last, buffer.data() + 18 * 8, sizeof(last));
+  RAISIN_CHECK(last == 18.);
+
+  State decoded;
+  decoded.getBuffer(buffer.data());
+  RAISIN_CHECK(decoded == state);
+
+  BufferReader reader(buffer.data(), buffer.size());
+  State read;
+  RAISIN_CHECK(read.getBuffer(reader) && read == state);
+
+  BufferReader truncated(buffer.data(), buffer.size() - 1);
+  State partial;
+  RAISIN_CHECK(!partial.getBuffer(truncated));
+
+  State resized = state;
+  resized.gv.resize(3);
+  RAISIN_CHECK(!(resized == state));
+
+  State::ConstView view(buffer.data());
+  RAISIN_CHECK(view.gc().size() == 19 && view.gc()[18] == 18. && view.gv().size() == 18 && view.quat()[0] == 1.f);
+
+  std::vector<unsigned char> delta;
+  const State previous = state;
+  state.gv[3] = 9.;
+  state.setBufferDelta(delta, previous);
+  State applied = previous;
+  applied.applyDelta(delta.data());
+  RAISIN_CHECK(applied == state);
+
+  RAISIN_CHECK(State::kTypeHash == PlainState::kTypeHash);
+  PlainState plain;
+  plain.getBuffer(buffer.data());
+  RAISIN_CHECK(plain.gc[18] == 18. && plain.gv.size() == 18 && plain.gv[0] == 2.5 && plain.quat[0] == 1.f &&
+               plain.id == 7);
+  return 0;
+}
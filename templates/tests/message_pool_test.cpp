@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// MessagePool: recycling without heap allocations, and threads acquiring and releasing concurrently
+// without ever sharing a node
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "raisin_test_msgs/msg/cloud.hpp"
+#include "raisin_test.hpp"
+
+static std::atomic<size_t> allocationCount{0};
+
+// counts heap allocations. every plain and array form is replaced, sized or not, so each pointer is released by
+// the free() that matches its malloc()
+static void* countedAllocate(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+using namespace raisin;
+using raisin_test_msgs::msg::Cloud;
+
+static Cloud makeCloud() {
+  Cloud cloud{};
+  cloud.name = "a name that is longer than the small string buffer";
+  cloud.tags = {"one", "two", "a tag that is longer than the small string buffer"};
+  cloud.data.assign(100, 1.5);
+  cloud.mask.assign(77, true);
+  cloud.points.resize(5);
+  cloud.raw.assign(300, 7);
+  return cloud;
+}
+
+static void testRecycling(const Cloud& cloud, const std::vector<unsigned char>& buffer) {
+  Cloud::Pool pool(4);
+  for (int i = 0; i < 10; i++) RAISIN_CHECK(*pool.acquire(buffer.data()) == cloud);
+  RAISIN_CHECK(pool.getAvailable() == 4);
+
+  const size_t before = allocationCount.load();
+  for (int i = 0; i < 1000; i++) {
+    auto msg = pool.acquire(buffer.data());
+    auto copy = msg;
+    RAISIN_CHECK(*copy == cloud);
+  }
+  RAISIN_CHECK(allocationCount.load() == before);
+
+  // an exhausted pool falls back to the heap and recovers all its nodes
+  {
+    std::vector<Cloud::SharedPtr> held;
+    for (int i = 0; i < 6; i++) held.push_back(pool.acquire());
+    RAISIN_CHECK(pool.getAvailable() == 0);
+  }
+  RAISIN_CHECK(pool.getAvailable() == 4);
+
+  Cloud::SharedPtr survivor;
+  {
+    Cloud::Pool shortLived(2);
+    survivor = shortLived.acquire(buffer.data());
+  }
+  RAISIN_CHECK(*survivor == cloud);
+}
+
+static void testConcurrent(const Cloud& cloud, const std::vector<unsigned char>& buffer) {
+  Cloud::Pool pool(4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 20000; i++) {
+        auto decoded = pool.acquire(buffer.data());
+        auto other = pool.acquire();
+        // a node handed to two threads at once would see the other thread's mark
+        const double mark = t * 1e6 + i;
+        other->origin.x = mark;
+        std::this_thread::yield();
+        RAISIN_CHECK(other->origin.x == mark);
+        RAISIN_CHECK(*decoded == cloud);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  RAISIN_CHECK(pool.getAvailable() == 4);
+}
+
+int main() {
+  const Cloud cloud = makeCloud();
+  std::vector<unsigned char> buffer;
+  cloud.setBuffer(buffer);
+  testRecycling(cloud, buffer);
+  testConcurrent(cloud, buffer);
+  return 0;
+}
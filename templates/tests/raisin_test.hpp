@@ -0,0 +1,25 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// checks shared by the tests of templates/tests. unlike assert(), they stay active in release builds
+
+#ifndef RAISIN_WS_TEST_HPP_
+#define RAISIN_WS_TEST_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+
+/// fails the test with the location of condition if it does not hold
+#define RAISIN_CHECK(condition)                                                          \
+  do {                                                                                   \
+    if (!(condition)) {                                                                  \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      std::exit(1);                                                                      \
+    }                                                                                    \
+  } while (false)
+
+#endif // RAISIN_WS_TEST_HPP_
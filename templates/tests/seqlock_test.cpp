@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// SeqLock: one writer storing while readers load on other threads. a reader never sees a torn value,
+// and the values and versions it sees never go back
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "raisin_seqlock.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+// 100 bytes, so the value spans several words and does not end on a word boundary
+struct Snapshot {
+  uint64_t counter;
+  double values[11];
+  uint32_t check;
+};
+
+constexpr uint64_t kStoreCount = 200000;
+
+static Snapshot makeSnapshot(uint64_t i) {
+  Snapshot snapshot;
+  snapshot.counter = i;
+  for (size_t k = 0; k < 11; k++) snapshot.values[k] = double(i) + double(k);
+  snapshot.check = uint32_t(i * 7);
+  return snapshot;
+}
+
+static bool isConsistent(const Snapshot& snapshot) {
+  const uint64_t i = snapshot.counter;
+  for (size_t k = 0; k < 11; k++)
+    if (snapshot.values[k] != double(i) + double(k)) return false;
+  return snapshot.check == uint32_t(i * 7);
+}
+
+static void testSingleThread() {
+  SeqLock<Snapshot> lock(makeSnapshot(3));
+  RAISIN_CHECK(lock.getVersion() == 0 && lock.load().counter == 3);
+  lock.store(makeSnapshot(4));
+  Snapshot snapshot;
+  RAISIN_CHECK(lock.tryLoad(snapshot) && snapshot.counter == 4 && isConsistent(snapshot));
+  RAISIN_CHECK(lock.getVersion() == 1);
+}
+
+static void testConcurrent() {
+  SeqLock<Snapshot> lock(makeSnapshot(0));
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; r++) {
+    readers.emplace_back([&] {
+      uint64_t previous = 0, previousVersion = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        const uint64_t version = lock.getVersion();
+        const Snapshot snapshot = lock.load();
+        RAISIN_CHECK(isConsistent(snapshot));
+        RAISIN_CHECK(snapshot.counter >= previous && snapshot.counter >= version && version >= previousVersion);
+        previous = snapshot.counter;
+        previousVersion = version;
+      }
+    });
+  }
+  for (uint64_t i = 1; i <= kStoreCount; i++) lock.store(makeSnapshot(i));
+  done.store(true, std::memory_order_release);
+  for (auto& reader : readers) reader.join();
+  RAISIN_CHECK(lock.getVersion() == kStoreCount && lock.load().counter == kStoreCount);
+}
+
+int main() {
+  testSingleThread();
+  testConcurrent();
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// SharedMemoryRing: loan rejection, and one writer publishing while readers hold leases on other threads.
+// a leased slot must not be overwritten, and a reader sees increasing sequences
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "raisin_shm_ring.hpp"
+#include "raisin_test_msgs/msg/point.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::Point;
+
+constexpr uint32_t kSlotCount = 8;
+constexpr uint32_t kSlotSize = 256;
+constexpr uint64_t kMessageCount = 200000;
+
+alignas(64) static unsigned char region[SharedMemoryRing::getRequiredSize(kSlotCount, kSlotSize)];
+alignas(64) static unsigned char otherRegion[SharedMemoryRing::getRequiredSize(kSlotCount, kSlotSize)];
+
+static void testLoans() {
+  SharedMemoryRing writer, other;
+  RAISIN_CHECK(writer.create(region, sizeof(region), kSlotCount, kSlotSize));
+  RAISIN_CHECK(other.create(otherRegion, sizeof(otherRegion), kSlotCount, kSlotSize));
+
+  auto loan = writer.loan();
+  loan.data()[0] = 9;
+  loan.setSize(1);
+  RAISIN_CHECK(writer.publish(std::move(loan)) == 0 && !loan);
+  // empty, moved-from and foreign loans are rejected, and a foreign loan stays with its ring
+  RAISIN_CHECK(writer.publish(SharedMemoryRing::Loan()) == SharedMemoryRing::kNoSequence);
+  RAISIN_CHECK(writer.publish(std::move(loan)) == SharedMemoryRing::kNoSequence);
+  auto foreign = other.loan();
+  RAISIN_CHECK(writer.publish(std::move(foreign)) == SharedMemoryRing::kNoSequence && foreign);
+
+  SharedMemoryRing reader;
+  RAISIN_CHECK(reader.attach(region, sizeof(region)));
+  SharedMemoryRing::Lease lease;
+  RAISIN_CHECK(reader.acquireNext(lease) && lease.getSequence() == 0 && lease.data()[0] == 9);
+  RAISIN_CHECK(!reader.acquireNext(lease));
+}
+
+static void testConcurrent() {
+  SharedMemoryRing writer;
+  RAISIN_CHECK(writer.create(region, sizeof(region), kSlotCount, kSlotSize));
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  std::vector<uint64_t> receivedCounts(2, 0);
+  for (size_t r = 0; r < receivedCounts.size(); r++) {
+    readers.emplace_back([&, r] {
+      SharedMemoryRing reader;
+      RAISIN_CHECK(reader.attach(region, sizeof(region)));
+      SharedMemoryRing::Lease lease;
+      uint64_t previous = 0, received = 0;
+      const auto read = [&] {
+        const Point* point = lease.get<Point>();
+        RAISIN_CHECK(point != nullptr);
+        const double x = point->x;
+        RAISIN_CHECK(x == double(lease.getSequence()) && point->y == 2. * x);
+        RAISIN_CHECK(received == 0 || lease.getSequence() > previous);
+        // the slot stays ours while the writer keeps publishing
+        std::this_thread::yield();
+        RAISIN_CHECK(point->x == x && point->z == -x);
+        previous = lease.getSequence();
+        received++;
+      };
+      while (!done.load(std::memory_order_acquire))
+        if (reader.acquireNext(lease)) read();
+      while (reader.acquireNext(lease)) read();
+      RAISIN_CHECK(received + reader.getLostCount() <= kMessageCount);
+      receivedCounts[r] = received;
+    });
+  }
+
+  for (uint64_t sequence = 0; sequence < kMessageCount;) {
+    auto loan = writer.loan();
+    if (!loan) {
+      std::this_thread::yield();
+      continue;
+    }
+    Point& point = loan.construct<Point>();
+    point.x = double(sequence);
+    point.y = 2. * point.x;
+    point.z = -point.x;
+    RAISIN_CHECK(writer.publish(std::move(loan)) == sequence);
+    sequence++;
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& reader : readers) reader.join();
+  for (uint64_t received : receivedCounts) RAISIN_CHECK(received > 0);
+}
+
+int main() {
+  testLoans();
+  testConcurrent();
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// round trips of an @soa field through every decoder, its view and delta encoding
+
+#include <vector>
+
+#include "raisin_test_msgs/msg/scan.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+using raisin_test_msgs::msg::Point;
+using raisin_test_msgs::msg::Scan;
+
+int main() {
+  Scan scan;
+  scan.id = 9;
+  scan.tail = 1.5f;
+  for (int i = 0; i < 1000; i++) {
+    Point point;
+    point.x = i;
+    point.y = 2 * i;
+    point.z = -i;
+    scan.points.push_back(point);
+  }
+
+  const std::vector<unsigned char> buffer = scan.serialize();
+  RAISIN_CHECK(buffer.size() == scan.getSize());
+
+  Scan decoded;
+  decoded.getBuffer(buffer.data());
+  RAISIN_CHECK(decoded == scan);
+
+  BufferReader reader(buffer);
+  Scan read;
+  RAISIN_CHECK(read.getBuffer(reader) && read == scan && reader.getRemaining() == 0);
+
+  Scan::ConstView view(buffer);
+  RAISIN_CHECK(view.points().size() == 1000 && view.points()[10].y == 20. && view.tail() == 1.5f);
+  RAISIN_CHECK(view.id() == 9 && view.getSize() == buffer.size());
+
+  SegmentWriter writer;
+  scan.appendSegments(writer);
+  std::vector<unsigned char> gathered;
+  writer.gather(gathered);
+  RAISIN_CHECK(gathered == buffer);
+
+  std::vector<unsigned char> delta;
+  scan.setBufferDelta(delta, Scan{}, true);
+  Scan applied;
+  applied.applyDelta(delta.data());
+  RAISIN_CHECK(applied == scan);
+
+  for (size_t size : {size_t(3), size_t(10), buffer.size() - 1}) {
+    BufferReader truncated(buffer.data(), size);
+    Scan partial;
+    RAISIN_CHECK(!partial.getBuffer(truncated));
+  }
+
+  Scan copied;
+  copied.points.assign(scan.points.toVector());
+  RAISIN_CHECK(copied.points == scan.points);
+  return 0;
+}
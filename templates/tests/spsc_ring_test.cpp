@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// SpscRing: capacity rounding, full and empty rings, and a producer and a consumer thread passing
+// variable-size elements. every element arrives once, in order, and slots keep their capacity
+
+#include <thread>
+#include <vector>
+
+#include "raisin_spsc_ring.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+constexpr size_t kElementCount = 200000;
+constexpr size_t kMaxElementSize = 32;
+
+static void testFullAndEmpty() {
+  SpscRing<int> ring(5);
+  RAISIN_CHECK(ring.capacity() == 8);
+  int val = 0;
+  RAISIN_CHECK(!ring.tryPop(val));
+  for (int i = 0; i < 8; i++) RAISIN_CHECK(ring.tryPush(i));
+  RAISIN_CHECK(!ring.tryPush(8) && ring.size() == 8);
+  for (int i = 0; i < 8; i++) RAISIN_CHECK(ring.tryPop(val) && val == i);
+  RAISIN_CHECK(!ring.tryPop(val) && ring.size() == 0);
+}
+
+static void testConcurrent() {
+  SpscRing<std::vector<uint32_t>> ring(64, std::vector<uint32_t>(kMaxElementSize));
+
+  std::thread consumer([&] {
+    size_t expected = 0;
+    while (expected < kElementCount) {
+      const bool consumed = ring.tryConsume([&](std::vector<uint32_t>& slot) {
+        RAISIN_CHECK(slot.size() == expected % kMaxElementSize && slot.capacity() >= kMaxElementSize);
+        for (uint32_t val : slot) RAISIN_CHECK(val == expected);
+      });
+      if (consumed) expected++;
+      else std::this_thread::yield();
+    }
+    std::vector<uint32_t> rest;
+    RAISIN_CHECK(!ring.tryPop(rest));
+  });
+
+  for (size_t i = 0; i < kElementCount;) {
+    const bool produced = ring.tryProduce([&](std::vector<uint32_t>& slot) {
+      // assign() reuses the slot's storage, so a prototype of the largest size means no allocation here
+      slot.assign(i % kMaxElementSize, uint32_t(i));
+    });
+    if (produced) i++;
+    else std::this_thread::yield();
+  }
+  consumer.join();
+  RAISIN_CHECK(ring.size() == 0);
+}
+
+int main() {
+  testFullAndEmpty();
+  testConcurrent();
+  return 0;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// TimedLoopScheduler: rejected rates, the earliest deadline running first, and stop() from another thread
+// interrupting the wait for a slow loop instead of waiting out its period
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raisin_timed_loop.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+static void testAddLoop() {
+  TimedLoopScheduler loops;
+  const auto noop = [] {};
+  RAISIN_CHECK(!loops.addLoop("empty", nullptr, 10.));
+  RAISIN_CHECK(!loops.addLoop("zero", noop, 0.) && !loops.addLoop("negative", noop, -1.));
+  RAISIN_CHECK(!loops.addLoop("nan", noop, std::numeric_limits<double>::quiet_NaN()));
+  RAISIN_CHECK(!loops.addLoop("infinite", noop, std::numeric_limits<double>::infinity()));
+  RAISIN_CHECK(!loops.addLoop("above a tick", noop, 1e300));
+  RAISIN_CHECK(!loops.runNext() && loops.getLoopCount() == 0);
+  RAISIN_CHECK(loops.addLoop("ok", noop, 10.) && loops.getName(loops.getLoopCount() - 1) == "ok");
+}
+
+static void testOrder() {
+  TimedLoopScheduler loops;
+  std::vector<std::string> order;
+  loops.addLoop("fast", [&] { order.push_back("fast"); }, 1000.);
+  loops.addLoop("slow", [&] { order.push_back("slow"); }, 100.);
+  // both are due right away, then fast runs every millisecond and slow every ten
+  for (int i = 0; i < 12; i++) RAISIN_CHECK(loops.runNext());
+  RAISIN_CHECK(order.size() == 12 && order[0] == "fast" && order[1] == "slow");
+  RAISIN_CHECK(loops.getRunCount(0) >= 10 && loops.getRunCount(1) >= 1 && loops.getRunCount(1) <= 2);
+}
+
+static void testStop() {
+  TimedLoopScheduler loops;
+  int runs = 0;
+  loops.addLoop("slow", [&] { runs++; }, 0.1);
+  std::thread thread([&] { loops.run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const auto start = std::chrono::steady_clock::now();
+  loops.stop();
+  thread.join();
+  // the second iteration is due after 10 s, the stop must not wait for it
+  RAISIN_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  RAISIN_CHECK(runs == 1 && loops.isStopped() && !loops.runNext());
+}
+
+int main() {
+  testAddLoop();
+  testOrder();
+  testStop();
+  return 0;
+}
@@ -0,0 +1,36 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// TopicIdTable: interned ids, and ids announced by the other side that move a topic or reuse an id
+
+#include <string>
+
+#include "raisin_serialization_base.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+int main() {
+  TopicIdTable table;
+  RAISIN_CHECK(table.intern("a") == 0 && table.intern("b") == 1 && table.intern("a") == 0);
+  uint32_t id = 99;
+  RAISIN_CHECK(table.find("b", id) && id == 1 && *table.find(1) == "b");
+  RAISIN_CHECK(!table.find(7) && !table.find("c", id));
+
+  // "a" moves to 5, so 0 no longer resolves to it
+  table.assign(5, "a");
+  RAISIN_CHECK(!table.find(0) && *table.find(5) == "a" && table.find("a", id) && id == 5);
+
+  // "c" takes over 1, so "b" is forgotten
+  table.assign(1, "c");
+  RAISIN_CHECK(*table.find(1) == "c" && !table.find("b", id));
+
+  // announcing the same mapping again changes nothing
+  table.assign(1, "c");
+  RAISIN_CHECK(*table.find(1) == "c" && table.find("c", id) && id == 1);
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// TripleBuffer: one writer publishing while one reader updates on another thread. the reader always sees
+// a whole value, newer than the one before, and the slots keep their capacity
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "raisin_gui_snapshot.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+constexpr uint64_t kPublishCount = 200000;
+constexpr size_t kValueSize = 16;
+
+static void testSingleThread() {
+  TripleBuffer<int> buffer(-1);
+  RAISIN_CHECK(!buffer.update() && buffer.get() == -1);
+  buffer.write(1);
+  buffer.write(2);
+  // only the newest value is handed over
+  RAISIN_CHECK(buffer.update() && buffer.get() == 2);
+  RAISIN_CHECK(!buffer.update() && buffer.get() == 2);
+}
+
+static void testConcurrent() {
+  TripleBuffer<std::vector<uint64_t>> buffer(std::vector<uint64_t>(kValueSize, 0));
+  std::atomic<bool> done{false};
+
+  std::thread reader([&] {
+    uint64_t previous = 0, updateCount = 0;
+    const auto read = [&] {
+      const auto& val = buffer.get();
+      RAISIN_CHECK(val.size() == kValueSize && val.front() > previous);
+      for (uint64_t word : val) RAISIN_CHECK(word == val.front());
+      previous = val.front();
+      updateCount++;
+    };
+    while (!done.load(std::memory_order_acquire))
+      if (buffer.update()) read();
+    if (buffer.update()) read();
+    RAISIN_CHECK(previous == kPublishCount && updateCount > 0);
+  });
+
+  for (uint64_t i = 1; i <= kPublishCount; i++) {
+    auto& val = buffer.getWriteBuffer();
+    const uint64_t* storage = val.data();
+    val.assign(kValueSize, i);
+    RAISIN_CHECK(val.data() == storage);
+    buffer.publish();
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+}
+
+int main() {
+  testSingleThread();
+  testConcurrent();
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Raion Robotics Inc.
+//
+// Any unauthorized copying, alteration, distribution, transmission,
+// performance, display or use of this material is prohibited.
+//
+// All rights reserved.
+
+// ChaseLevDeque: an owner pushing and popping while thieves steal, every item is taken exactly once.
+// WorkStealingPool runs every task, and a SerialQueue keeps its tasks in order
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "raisin_work_stealing.hpp"
+#include "raisin_test.hpp"
+
+using namespace raisin;
+
+constexpr int kItemCount = 200000;
+
+static void testDeque() {
+  ChaseLevDeque<int> deque(4);
+  int items[5];
+  for (int i = 0; i < 4; i++) RAISIN_CHECK(deque.push(&items[i]));
+  RAISIN_CHECK(!deque.push(&items[4]));
+  // thieves take the oldest item, the owner the newest
+  RAISIN_CHECK(deque.steal() == &items[0] && deque.pop() == &items[3]);
+  RAISIN_CHECK(deque.pop() == &items[2] && deque.steal() == &items[1]);
+  RAISIN_CHECK(!deque.pop() && !deque.steal() && deque.empty());
+}
+
+static void testConcurrentDeque() {
+  ChaseLevDeque<int> deque(256);
+  std::vector<int> items(kItemCount);
+  std::vector<std::atomic<int>> taken(kItemCount);
+  const auto take = [&](int* item) { taken[item - items.data()].fetch_add(1, std::memory_order_relaxed); };
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; t++) {
+    thieves.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire))
+        if (int* item = deque.steal()) take(item);
+    });
+  }
+  for (int i = 0; i < kItemCount; i++) {
+    while (!deque.push(&items[i]))
+      if (int* item = deque.pop()) take(item);
+    // the owner also pops, so it races the thieves for the last item
+    if (i % 3 == 0)
+      if (int* item = deque.pop()) take(item);
+  }
+  while (int* item = deque.pop()) take(item);
+  done.store(true, std::memory_order_release);
+  for (auto& thief : thieves) thief.join();
+  RAISIN_CHECK(deque.empty());
+  for (const auto& count : taken) RAISIN_CHECK(count.load() == 1);
+}
+
+static void testPool() {
+  std::atomic<int> runCount{0};
+  std::vector<int> order;
+  {
+    WorkStealingPool pool(4);
+    SerialQueue queue(pool);
+    // tasks submitted from a worker land on its deque, where the other workers steal them
+    pool.submit([&] {
+      for (int i = 0; i < 1000; i++) pool.submit([&] { runCount.fetch_add(1, std::memory_order_relaxed); });
+    });
+    for (int i = 0; i < 5000; i++) queue.post([&order, i] { order.push_back(i); });
+    while (queue.isBusy()) std::this_thread::yield();
+  }
+  // the pool runs the tasks still queued before its destructor returns
+  RAISIN_CHECK(runCount.load() == 1000);
+  RAISIN_CHECK(order.size() == 5000);
+  for (int i = 0; i < 5000; i++) RAISIN_CHECK(order[i] == i);
+}
+
+int main() {
+  testDeque();
+  testConcurrentDeque();
+  testPool();
+  return 0;
+}